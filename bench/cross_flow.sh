@@ -0,0 +1,175 @@
+#!/bin/sh
+# bench/cross_flow.sh — driven by `make -C bench` (see README, "Cross-flow benchmark")
+# Runs the same vector sets (gen_vectors.py, one file per N in SIZES, all
+# prefixes of one seed's stream; FORMAT=addv golden stores that every flow
+# maps through vecstore.h / vecstore.py, or FORMAT=addb input files) through
+# every flow in FLOWS:
+#
+#   file      file-based/adder/sw  cosim_tb --vectors=FILE   (Questa/ModelSim vsim)
+#   verilator rv_adder_example     +test=vectors +vectors=FILE (tracing/coverage off, 1 thread)
+#   cocotb    cocotb_rv_adder      test_adder_rv_vectors, PLUSARGS=+vectors=FILE
+#
+# Every flow drives in_valid=1 / out_ready=1 and checks each sum. Per run it
+# records wall time and peak RSS (/usr/bin/time), and per flow:
+#   compile_s  one-off build: the Verilator model build, or for file/cocotb the
+#              first run minus a second identical run at the smallest N
+#   startup_s  the (warm) run at the smallest N: process, elaboration, reset
+#   ns_per_txn (wall - startup) / (N - smallest N), so it excludes both
+# A flow whose tool is not on PATH is reported as SKIP. Any failing run makes
+# the script exit 1.
+set -u
+
+HERE=$(cd "$(dirname "$0")" && pwd)
+ROOT=$(cd "$HERE/.." && pwd)
+MAKE=${MAKE:-make}
+PYTHON=${PYTHON:-python3}
+SIZES=${SIZES:-1000 10000 100000 1000000 10000000}
+SEED=${SEED:-1}
+FORMAT=${FORMAT:-addv}
+FLOWS=${FLOWS:-file verilator cocotb}
+OUT=${OUT:-$HERE/results}
+CSV=$OUT/cross_flow.csv
+
+FDIR=$ROOT/file-based/adder/sw
+VDIR=$ROOT/verilator-based/rv_adder_example
+CDIR=$ROOT/verilator-based/cocotb_rv_adder/sim
+VBUILD=obj_xflow
+CBUILD=sim_build_xflow
+
+mkdir -p "$OUT/logs"
+SIZES=$(for n in $SIZES; do echo "$n"; done | sort -n -u | tr '\n' ' ')
+NMIN=$(echo "$SIZES" | awk '{ print $1 }')
+
+$PYTHON "$HERE/gen_vectors.py" --seed="$SEED" --out="$OUT/vectors" --format="$FORMAT" $SIZES > "$OUT/logs/gen.log" || {
+    echo "gen_vectors.py failed (see $OUT/logs/gen.log)" >&2
+    exit 1
+}
+case $FORMAT in
+    addv) EXT=addv ;;
+    *) EXT=bin ;;
+esac
+vec() { echo "$OUT/vectors/vec_$1.$EXT"; }
+
+now() { date +%s.%N; }
+have() { command -v "$1" > /dev/null 2>&1; }
+sub() { echo "$1 $2" | awk '{ printf "%.3f", $1 - $2 }'; }
+
+# timed LOG CMD...: run CMD (output to LOG), set WALL (s), RSS (KiB, largest
+# process of the tree) and RC
+timed() {
+    log=$1
+    shift
+    if [ -x /usr/bin/time ]; then
+        /usr/bin/time -f "%e %M" -o "$log.time" "$@" > "$log" 2>&1
+        RC=$?
+        WALL=$(tail -n 1 "$log.time" | awk '{ print $1 }')
+        RSS=$(tail -n 1 "$log.time" | awk '{ print $2 }')
+    else
+        t0=$(now)
+        "$@" > "$log" 2>&1
+        RC=$?
+        WALL=$(sub "$(now)" "$t0")
+        RSS=NA
+    fi
+}
+
+# One flow's run over vec_<N>.bin: run_<flow> N LOG
+run_file() {
+    timed "$2" sh -c 'cd "$1" && exec ./cosim_tb --vectors="$2" $3' sh "$FDIR" "$(vec "$1")" "${3:-}"
+    [ $RC -eq 0 ] && grep -q "\[C-TB\] PASS" "$2" || RC=1
+}
+run_verilator() {
+    timed "$2" sh -c 'cd "$1" && exec "./$2/sim_adder_rv_simple" +test=vectors +vectors="$3" \
+        +trace=0 +p_ready=100 +dut_stats=0 +perf="$4.json" +cov="$4.dat"' \
+        sh "$VDIR" "$VBUILD" "$(vec "$1")" "$2"
+}
+run_cocotb() {
+    timed "$2" $MAKE -C "$CDIR" SIM_BUILD="$CBUILD" WAVES=0 THREADS=1 \
+        TESTCASE=test_adder_rv_vectors COCOTB_TEST_FILTER=test_adder_rv_vectors \
+        COCOTB_RESULTS_FILE="$2.xml" PLUSARGS="+vectors=$(vec "$1")"
+    [ $RC -eq 0 ] && [ -s "$2.xml" ] && ! grep -q "<failure\|<error\|<skipped" "$2.xml" || RC=1
+}
+
+# Build step per flow; sets COMPILE (s) or returns 1
+build_verilator() {
+    timed "$OUT/logs/verilator.build.log" $MAKE -C "$VDIR" -s build BUILD="$VBUILD" \
+        TRACE=0 COVERAGE=0 THREADS=1
+    COMPILE=$WALL
+    return $RC
+}
+build_file() {
+    $MAKE -C "$FDIR" -s cosim_tb > "$OUT/logs/file.build.log" 2>&1 || return 1
+    # the first run compiles the work library (vlog), the second reuses it
+    run_file "$NMIN" "$OUT/logs/file.cold.log" --rebuild
+    [ $RC -eq 0 ] || return 1
+    COLD=$WALL
+    COMPILE=
+}
+build_cocotb() {
+    rm -rf "${CDIR:?}/$CBUILD"
+    run_cocotb "$NMIN" "$OUT/logs/cocotb.cold.log"
+    [ $RC -eq 0 ] || return 1
+    COLD=$WALL
+    COMPILE=
+}
+
+tool_for() {
+    case $1 in
+        file) echo vsim ;;
+        verilator) echo verilator ;;
+        cocotb) echo cocotb-config ;;
+        *) echo "" ;;
+    esac
+}
+
+echo "flow,n,result,wall_s,peak_rss_kb,compile_s,startup_s,ns_per_txn" > "$CSV"
+rc=0
+
+for f in $FLOWS; do
+    tool=$(tool_for "$f")
+    if [ -z "$tool" ]; then
+        echo "unknown flow '$f' (file, verilator, cocotb)" >&2
+        exit 2
+    fi
+    if ! have "$tool" || { [ "$f" = cocotb ] && ! have verilator; }; then
+        echo "$f,-,SKIP,NA,NA,NA,NA,NA" >> "$CSV"
+        echo "  $f: $tool not found, skipped" >&2
+        continue
+    fi
+
+    COLD=
+    COMPILE=
+    if ! "build_$f"; then
+        echo "$f,-,FAIL,NA,NA,NA,NA,NA" >> "$CSV"
+        echo "  $f: build failed (see $OUT/logs/$f.*.log)" >&2
+        rc=1
+        continue
+    fi
+
+    START=
+    for n in $SIZES; do
+        log=$OUT/logs/$f.$n.log
+        "run_$f" "$n" "$log"
+        if [ $RC -ne 0 ]; then
+            echo "$f,$n,FAIL,$WALL,$RSS,NA,NA,NA" >> "$CSV"
+            echo "  $f: N=$n failed (see $log)" >&2
+            rc=1
+            continue
+        fi
+        if [ -z "$START" ]; then
+            START=$WALL
+            [ -n "$COLD" ] && COMPILE=$(sub "$COLD" "$START")
+            nspt=NA
+        else
+            nspt=$(echo "$WALL $START $n $NMIN" | awk '{ printf "%.1f", 1e9 * ($1 - $2) / ($3 - $4) }')
+        fi
+        echo "$f,$n,PASS,$WALL,$RSS,${COMPILE:-NA},$START,$nspt" >> "$CSV"
+    done
+done
+
+# Table
+printf '\n%-10s %9s %6s %9s %12s %10s %10s %11s\n' flow N result wall_s peak_rss_kb compile_s startup_s ns/txn
+awk -F, 'NR > 1 { printf "%-10s %9s %6s %9s %12s %10s %10s %11s\n", $1, $2, $3, $4, $5, $6, $7, $8 }' "$CSV"
+echo
+echo "CSV      : $CSV"
+exit $rc
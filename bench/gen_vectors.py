@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# bench/gen_vectors.py — shared operand sets for bench/cross_flow.sh
+"""Write one vector file per N, all prefixes of the same stream.
+
+    gen_vectors.py [--seed=S] [--out=DIR] [--format=addb|addv]
+                   [--valid=P] [--ready=P] [--cycles=C] N [N ...]
+        ->  DIR/vec_<N>.bin (addb) or DIR/vec_<N>.addv
+
+The stream is cosim_tb.cpp's LCG for seed S, so vec_<N> holds exactly the
+operands `cosim_tb --n=N --seed=S` would generate itself.
+
+--format=addb (default) is the file-based flow's binary input file
+(cosim_tb.cpp, "Binary vector files"): 16-byte header {"ADDB", u16 version 1,
+u16 width 32, u64 count}, then little-endian u32 a, b per record.
+
+--format=addv is the golden vector store (vecstore.h / vecstore.py): page-
+aligned columns a, b and the expected sum, for harnesses that mmap the file
+instead of reading it. --valid=P / --ready=P add per-cycle in_valid /
+out_ready schedules, P percent of C cycles high (default C = 2N, later cycles
+count as high), drawn from random.Random(S).
+
+Every flow reads both (cosim_tb --vectors, tb_main +test=vectors +vectors,
+cocotb +vectors).
+"""
+import array
+import os
+import random
+import struct
+import sys
+
+from vecstore import write_addv
+
+LCG_A, LCG_C = 1664525, 1013904223
+USAGE = "usage: {} [--seed=S] [--out=DIR] [--format=addb|addv] [--valid=P] [--ready=P] [--cycles=C] N [N ...]"
+
+
+def lcg_stream(seed, n_words):
+    out = array.array("I", bytes(4 * n_words))
+    s = seed & 0xFFFFFFFF
+    for i in range(n_words):
+        s = (s * LCG_A + LCG_C) & 0xFFFFFFFF
+        out[i] = s
+    return out
+
+
+def schedule(rng, pct, cycles):
+    """Bitmap of `cycles` bits (LSB first), padded to whole u64 words."""
+    bits = bytearray((cycles + 63) // 64 * 8)
+    for t in range(cycles):
+        if rng.randrange(100) < pct:
+            bits[t >> 3] |= 1 << (t & 7)
+    return bytes(bits)
+
+
+def main(argv):
+    seed, out_dir, fmt, sizes = 1, "vectors", "addb", []
+    p_valid = p_ready = cycles = None
+    try:
+        for a in argv[1:]:
+            if a.startswith("--seed="):
+                seed = int(a[7:], 0)
+            elif a.startswith("--out="):
+                out_dir = a[6:]
+            elif a.startswith("--format=") and a[9:] in ("addb", "addv"):
+                fmt = a[9:]
+            elif a.startswith("--valid="):
+                p_valid = int(a[8:])
+            elif a.startswith("--ready="):
+                p_ready = int(a[8:])
+            elif a.startswith("--cycles="):
+                cycles = int(a[9:])
+            elif a.isdigit() and int(a) > 0:
+                sizes.append(int(a))
+            else:
+                raise ValueError(a)
+    except ValueError:
+        sizes = []
+    if not sizes or (fmt == "addb" and (p_valid, p_ready, cycles) != (None, None, None)):
+        print(USAGE.format(argv[0]), file=sys.stderr)
+        return 2
+
+    os.makedirs(out_dir, exist_ok=True)
+    words = lcg_stream(seed, 2 * max(sizes))
+    if sys.byteorder != "little":
+        words.byteswap()
+    data = memoryview(words).cast("B")
+    for n in sorted(set(sizes)):
+        if fmt == "addb":
+            path = os.path.join(out_dir, f"vec_{n}.bin")
+            with open(path, "wb") as f:
+                f.write(b"ADDB" + struct.pack("<HHQ", 1, 32, n))
+                f.write(data[: 8 * n])
+        else:
+            path = os.path.join(out_dir, f"vec_{n}.addv")
+            c = cycles if cycles is not None else 2 * n
+            rng = random.Random(seed)
+            valid = schedule(rng, p_valid, c) if p_valid is not None else None
+            ready = schedule(rng, p_ready, c) if p_ready is not None else None
+            write_addv(path, words[0 : 2 * n : 2], words[1 : 2 * n : 2], width=32, seed=seed,
+                       valid=valid, ready=ready, cycles=c)
+        print(f"{path}: {n} vectors, seed {seed}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,211 @@
+// bench/vecstore.h
+// Read-only, memory-mapped golden vector store shared by every flow.
+//
+// One file holds a golden set once: operands, expected sums and, optionally,
+// per-cycle valid/ready schedules, in packed little-endian columns that a
+// harness uses straight from the mapping (no parse, no copy). Shards of one
+// run, and concurrent runs, map the same file and share its pages in the page
+// cache, so a 10^8-vector set is generated once (bench/gen_vectors.py
+// --format=addv) instead of by every job.
+//
+// ADDV v1 layout (all integers little-endian):
+//    0  char[4]  magic       "ADDV"
+//    4  u16      version     1
+//    6  u16      width       operand width in bits
+//    8  u16      word_bytes  bytes per column entry: 4 (W <= 32) or 8 (W <= 64)
+//   10  u16      reserved    0
+//   12  u32      reserved    0
+//   16  u64      count       number of vectors
+//   24  u64      cycles      length of the schedules in cycles, 0 without them
+//   32  u64      seed        generator seed (informational)
+//   40  u64      off_a       byte offset of column a[count]
+//   48  u64      off_b       ... b[count]
+//   56  u64      off_sum     ... sum[count] (W-bit wrap-around), 0 = absent
+//   64  u64      off_valid   bitmap of in_valid per cycle (bit t of u64 word t/64), 0 = absent
+//   72  u64      off_ready   bitmap of out_ready per cycle, 0 = absent
+// Columns start on 4 KiB boundaries, so a shard's slice of any column lies in
+// whole pages of its own. A cycle beyond the schedule, or a schedule that is
+// absent, is valid / ready.
+//
+// The file-based flow's ADDB input files (cosim_tb.cpp, "Binary vector
+// files") open through the same class: a and b are then one interleaved
+// column and there is no sum column or schedule.
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+class VecStore {
+public:
+    static constexpr uint16_t kVersion  = 1;
+    static constexpr uint64_t kHdrBytes = 80;
+    static constexpr uint64_t kAlign    = 4096;
+
+    VecStore() = default;
+    VecStore(const VecStore&) = delete;
+    VecStore& operator=(const VecStore&) = delete;
+    ~VecStore() { close(); }
+
+    // Map PATH (ADDV or ADDB) and check its layout against the file size
+    bool open(const std::string& path, std::string* err) {
+        close();
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) { *err = "cannot read " + path; return false; }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || (uint64_t)st.st_size < 16) {
+            ::close(fd);
+            *err = path + " is not a vector file";
+            return false;
+        }
+        m_size = (uint64_t)st.st_size;
+        void* p = ::mmap(nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);   // the mapping keeps the file
+        if (p == MAP_FAILED) { *err = "cannot map " + path; m_size = 0; return false; }
+        m_base = static_cast<const unsigned char*>(p);
+        if (!parse(path, err)) { close(); return false; }
+        return true;
+    }
+
+    void close() {
+        if (m_base) ::munmap(const_cast<unsigned char*>(m_base), m_size);
+        m_base = nullptr;
+        m_size = 0;
+        m_a = m_b = m_sum = nullptr;
+        m_valid = m_ready = nullptr;
+        m_count = m_cycles = 0;
+    }
+
+    bool        is_open() const { return m_base != nullptr; }
+    const char* format() const { return m_stride == 2 ? "ADDB" : "ADDV"; }
+    unsigned    width() const { return m_width; }
+    uint64_t    count() const { return m_count; }
+    uint64_t    cycles() const { return m_cycles; }
+    uint64_t    seed() const { return m_seed; }
+    bool        has_sum() const { return m_sum != nullptr; }
+    bool        has_valid() const { return m_valid != nullptr; }
+    bool        has_ready() const { return m_ready != nullptr; }
+
+    uint64_t a(uint64_t i) const { return word(m_a + i * m_stride * m_wb); }
+    uint64_t b(uint64_t i) const { return word(m_b + i * m_stride * m_wb); }
+    // Stored golden sum; callers check has_sum() or compute a + b themselves
+    uint64_t sum(uint64_t i) const { return word(m_sum + i * m_wb); }
+
+    bool valid(uint64_t t) const { return bit(m_valid, t); }
+    bool ready(uint64_t t) const { return bit(m_ready, t); }
+
+    // Contiguous u32 columns (word_bytes 4): for harnesses that stream them
+    // directly; stride is 2 for ADDB, 1 for ADDV
+    const uint32_t* a32() const { return m_wb == 4 ? reinterpret_cast<const uint32_t*>(m_a) : nullptr; }
+    const uint32_t* b32() const { return m_wb == 4 ? reinterpret_cast<const uint32_t*>(m_b) : nullptr; }
+    const uint32_t* sum32() const { return m_wb == 4 ? reinterpret_cast<const uint32_t*>(m_sum) : nullptr; }
+    unsigned        stride() const { return m_stride; }
+
+    // Vectors [first, first+n) will be read soon (shards call this for their
+    // slice); the rest of the file is read sequentially or not at all
+    void will_need(uint64_t first, uint64_t n) const {
+        if (!m_base || first >= m_count) return;
+        if (n > m_count - first) n = m_count - first;
+        const uint64_t span = n * m_stride * m_wb;
+        advise(m_a + first * m_stride * m_wb, span, MADV_WILLNEED);
+        if (m_stride == 1) advise(m_b + first * m_wb, span, MADV_WILLNEED);
+        if (m_sum) advise(m_sum + first * m_wb, n * m_wb, MADV_WILLNEED);
+    }
+
+private:
+    static uint64_t le(const unsigned char* p, unsigned nbytes) {
+        uint64_t v = 0;
+        for (unsigned i = nbytes; i-- > 0; ) v = (v << 8) | p[i];
+        return v;
+    }
+
+    uint64_t word(const unsigned char* p) const {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        if (m_wb == 4) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+#else
+        return le(p, m_wb);
+#endif
+    }
+
+    bool bit(const unsigned char* map, uint64_t t) const {
+        return !map || t >= m_cycles || ((map[t >> 3] >> (t & 7)) & 1);
+    }
+
+    void advise(const unsigned char* p, uint64_t len, int how) const {
+        const uintptr_t lo = reinterpret_cast<uintptr_t>(p) & ~(uintptr_t)(kAlign - 1);
+        ::madvise(reinterpret_cast<void*>(lo), (size_t)(reinterpret_cast<uintptr_t>(p) + len - lo), how);
+    }
+
+    // Column at OFF of LEN bytes, or nullptr (and *ok = false) if it does not fit
+    const unsigned char* column(uint64_t off, uint64_t len, bool* ok) const {
+        if (off < kHdrBytes || off > m_size || len > m_size - off) { *ok = false; return nullptr; }
+        return m_base + off;
+    }
+
+    bool parse(const std::string& path, std::string* err) {
+        const unsigned char* h = m_base;
+        if (std::memcmp(h, "ADDB", 4) == 0) {
+            m_width  = (unsigned)le(h + 6, 2);
+            m_wb     = (m_width + 7) / 8;
+            m_count  = le(h + 8, 8);
+            m_stride = 2;
+            if (le(h + 4, 2) != 1 || (m_wb != 4 && m_wb != 8)) {
+                *err = path + " is not an ADDB v1 file of 32- or 64-bit operands";
+                return false;
+            }
+            if (m_count > (m_size - 16) / (2 * m_wb)) {
+                *err = path + " is shorter than its header says";
+                return false;
+            }
+            m_a = h + 16;
+            m_b = h + 16 + m_wb;
+            return true;
+        }
+        if (m_size < kHdrBytes || std::memcmp(h, "ADDV", 4) != 0 || le(h + 4, 2) != kVersion) {
+            *err = path + " is not an ADDV v1 or ADDB v1 vector file";
+            return false;
+        }
+        m_width  = (unsigned)le(h + 6, 2);
+        m_wb     = (unsigned)le(h + 8, 2);
+        m_count  = le(h + 16, 8);
+        m_cycles = le(h + 24, 8);
+        m_seed   = le(h + 32, 8);
+        m_stride = 1;
+        if ((m_wb != 4 && m_wb != 8) || m_width == 0 || m_width > 8 * m_wb) {
+            *err = path + ": unsupported width " + std::to_string(m_width) + " in " +
+                   std::to_string(m_wb) + "-byte words";
+            return false;
+        }
+        const uint64_t col = m_count * m_wb, sched = (m_cycles + 63) / 64 * 8;
+        bool ok = m_count <= m_size / m_wb;
+        m_a = column(le(h + 40, 8), col, &ok);
+        m_b = column(le(h + 48, 8), col, &ok);
+        if (const uint64_t off = le(h + 56, 8)) m_sum = column(off, col, &ok);
+        if (const uint64_t off = le(h + 64, 8)) m_valid = column(off, sched, &ok);
+        if (const uint64_t off = le(h + 72, 8)) m_ready = column(off, sched, &ok);
+        if (!ok) {
+            *err = path + " is shorter than its header says";
+            return false;
+        }
+        ::madvise(const_cast<unsigned char*>(m_base), (size_t)m_size, MADV_SEQUENTIAL);
+        return true;
+    }
+
+    const unsigned char* m_base = nullptr;
+    uint64_t m_size = 0;
+    unsigned m_width = 0, m_wb = 0, m_stride = 1;
+    uint64_t m_count = 0, m_cycles = 0, m_seed = 0;
+    const unsigned char* m_a = nullptr;
+    const unsigned char* m_b = nullptr;
+    const unsigned char* m_sum = nullptr;
+    const unsigned char* m_valid = nullptr;
+    const unsigned char* m_ready = nullptr;
+};
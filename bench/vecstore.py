@@ -0,0 +1,99 @@
+# bench/vecstore.py — Python side of the golden vector store (vecstore.h)
+"""Map an ADDV (or ADDB) vector file read-only and index it in place.
+
+    st = VecStore(path)
+    st.count, st.width, st.a[i], st.b[i], st.sum[i] (None without a sum column)
+    st.valid(t), st.ready(t)      # schedules; True beyond them or without them
+
+The columns are memoryviews over one shared mmap, so opening a 10^8-vector
+file costs nothing and concurrent readers share the page cache. Layout and
+rules are documented in vecstore.h; write_addv() below is the only writer.
+"""
+import mmap
+import struct
+import sys
+
+HDR = struct.Struct("<4sHHHHIQQQQQQQQ")   # 80 bytes, see vecstore.h
+ALIGN = 4096
+
+
+def _align(n):
+    return (n + ALIGN - 1) // ALIGN * ALIGN
+
+
+class VecStore:
+    def __init__(self, path):
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        buf = memoryview(self._map)
+        if sys.byteorder != "little":
+            raise ValueError(f"{path}: vector columns are little-endian")
+        self.sum = None
+        self._valid = self._ready = None
+        self.cycles = 0
+        self.seed = 0
+        if buf[:4] == b"ADDB":
+            _, version, width, count = struct.unpack_from("<4sHHQ", buf)
+            if version != 1 or width != 32 or len(buf) < 16 + 8 * count:
+                raise ValueError(f"{path}: not an ADDB v1 file of 32-bit operands")
+            ops = buf[16:16 + 8 * count].cast("I")
+            self.a, self.b = ops[0::2], ops[1::2]
+        elif buf[:4] == b"ADDV" and len(buf) >= HDR.size:
+            (_, version, width, wb, _, _, count, self.cycles, self.seed,
+             off_a, off_b, off_sum, off_valid, off_ready) = HDR.unpack_from(buf)
+            if version != 1 or wb not in (4, 8) or not 0 < width <= 8 * wb:
+                raise ValueError(f"{path}: not an ADDV v1 file of 32- or 64-bit words")
+            fmt, col, sched = "I" if wb == 4 else "Q", count * wb, (self.cycles + 63) // 64 * 8
+
+            def column(off, n):
+                if off < HDR.size or off + n > len(buf):
+                    raise ValueError(f"{path} is shorter than its header says")
+                return buf[off:off + n]
+
+            self.a = column(off_a, col).cast(fmt)
+            self.b = column(off_b, col).cast(fmt)
+            if off_sum:
+                self.sum = column(off_sum, col).cast(fmt)
+            if off_valid:
+                self._valid = column(off_valid, sched)
+            if off_ready:
+                self._ready = column(off_ready, sched)
+        else:
+            raise ValueError(f"{path}: not an ADDV v1 or ADDB v1 vector file")
+        self.width, self.count = width, count
+
+    def _bit(self, bits, t):
+        return bits is None or t >= self.cycles or bool((bits[t >> 3] >> (t & 7)) & 1)
+
+    def valid(self, t):
+        return self._bit(self._valid, t)
+
+    def ready(self, t):
+        return self._bit(self._ready, t)
+
+
+def write_addv(path, a, b, width=32, seed=0, valid=None, ready=None, cycles=0):
+    """a, b: array('I') (or 'Q') of count operands; valid/ready: bitmaps of `cycles` bits."""
+    if sys.byteorder != "little":
+        raise ValueError("vector columns are little-endian")
+    count = len(a)
+    mask = (1 << width) - 1
+    s = type(a)(a.typecode, ((x + y) & mask for x, y in zip(a, b)))
+    col = count * a.itemsize
+    sched = (cycles + 63) // 64 * 8
+    offs, pos = [], ALIGN
+    for present, n in ((True, col), (True, col), (True, col),
+                       (valid is not None, sched), (ready is not None, sched)):
+        offs.append(pos if present else 0)
+        pos = _align(pos + n) if present else pos
+    if valid is None and ready is None:
+        cycles = 0
+    hdr = HDR.pack(b"ADDV", 1, width, a.itemsize, 0, 0, count, cycles, seed, *offs)
+    with open(path, "wb") as f:
+        f.write(hdr)
+        for off, data in zip(offs, (a, b, s, valid, ready)):
+            if not off:
+                continue
+            f.seek(off)
+            f.write(memoryview(data).cast("B"))
+        f.truncate(pos)
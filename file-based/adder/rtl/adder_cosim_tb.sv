@@ -1,9 +1,24 @@
 // adder_cosim_tb_fixed.sv
 // Questa/ModelSim file-based harness for adder_rv_simple (Linux-friendly)
-// - Reads hex pairs from a text file
-// - Drives ready/valid into DUT (producer holds until in_ready on posedge)
-// - Keeps out_ready=1 and writes sums to an output text file
-// Supports compile-time macros for file paths; optional plusargs can override.
+// - Reads operand pairs from a packed binary vector file (bulk $fread) or,
+//   for debugging, hex pairs from a text file; the format is detected from
+//   the input header and the outputs are written in the same format; binary
+//   files may be named pipes (host streaming mode), so the input is never
+//   seeked once the header identified it as binary
+// - Drives ready/valid into DUT back-to-back (in_valid held high across items,
+//   next item prefetched) or, with +cosim_drive=item, one item at a time
+// - Keeps out_ready=1, or +cosim_ready_pct=P for random backpressure, and
+//   writes sums to the output file
+// - +cosim_out_blocks=1 (binary only): sums are collected in two fixed-size
+//   buffers and written a whole block at a time, each behind a sync header,
+//   while the other buffer fills; the host tails the file and checks every
+//   block as soon as it is complete (ADDS v2, see sw/cosim_tb.cpp)
+// Supports compile-time macros for file paths; plusargs override them at run
+// time (the host uses +cosim_inputs=/+cosim_outputs= so one compiled library
+// serves any vector paths).
+// Binary layout: see "Binary vector files" in sw/cosim_tb.cpp.
+// Compiled with +define+COSIM_DPI and run with +cosim_shm=<name>, vectors come
+// from the host's shared-memory rings through DPI-C (sw/cosim_dpi.cpp) instead.
 //
 // Macros (string literals) you can pass via vlog +define:
 //   COSIM_INPUTS  -> default "inputs.txt"
@@ -60,21 +75,164 @@ module adder_cosim_tb;
 
   // I/O handles and counters
   integer fin, fout;
-  int n_sent = 0;
-  int n_written = 0;
+  longint n_sent = 0;
+  longint n_written = 0;
+  longint n_fetched = 0;
 
   string line;
   logic [W-1:0] a, b;
   int r;
 
+  // Driver mode and optional consumer backpressure (plusargs)
+  //   +cosim_drive=stream   back-to-back: in_valid stays high across items (default)
+  //   +cosim_drive=item     original handshake, one item then an idle cycle
+  //   +cosim_ready_pct=P    out_ready high on P% of cycles (default 100)
+  string  drive = "stream";
+  int     ready_pct = 100;
+  longint t_start, n_cycles;
+
+  // Binary vector files: 16-byte header + little-endian records
+  localparam int NB    = (W + 7) / 8;      // bytes per field
+  localparam int CHUNK = 4096;             // input records per $fread
+  bit           bin_io = 0;
+  logic [7:0]   hdr  [16];
+  logic [7:0]   rbuf [CHUNK * 2 * NB];
+  longint       n_total = -1;              // record count, -1 = until EOF (text)
+  int           rb_pos = 0, rb_cnt = 0;    // records used / held in rbuf
+
+  function automatic longint unsigned hdr_le(int off, int nbytes);
+    longint unsigned v = 0;
+    for (int k = nbytes - 1; k >= 0; k--) v = (v << 8) | hdr[off + k];
+    return v;
+  endfunction
+
+  function automatic logic [W-1:0] rbuf_le(int off);
+    logic [W-1:0] v = '0;
+    for (int k = NB - 1; k >= 0; k--) v = (v << 8) | rbuf[off + k];
+    return v;
+  endfunction
+
+  task automatic put_le(longint unsigned v, int nbytes);
+    for (int k = 0; k < nbytes; k++) $fwrite(fout, "%c", 8'(v >> (8 * k)));
+  endtask
+
+  // Blocked outputs: OBLK sums per block, double-buffered. The consumer fills
+  // obuf[ob_cur]; a full buffer is handed to the negedge flusher and the
+  // consumer carries on in the other one. A block is one 4-word header
+  // {sync "SBLK", sequence number, valid sums, XOR of the valid sums} and
+  // OBLK 32-bit sums (the last block is padded), each written by a single
+  // $fwrite %u (2-state binary, least significant word first).
+  localparam int          OBLK     = 1024;          // sums per block (cosim_tb.cpp kBlkRecs)
+  localparam int unsigned BLK_SYNC = 32'h4B4C4253;  // "SBLK" in file byte order
+  bit                     blk_io   = 0;
+  logic [OBLK-1:0][31:0]  obuf [2];
+  int                     ob_cur = 0, ob_fill = 0;
+  logic [31:0]            ob_xor = '0;
+  int                     ob_pend = -1;             // buffer waiting for the flusher
+  int                     ob_pend_n;
+  logic [31:0]            ob_pend_xor;
+  int unsigned            ob_seq = 0;
+
+  task automatic flush_block(int idx, int n, logic [31:0] x);
+    $fwrite(fout, "%u", {x, 32'(n), 32'(ob_seq), BLK_SYNC});
+    $fwrite(fout, "%u", obuf[idx]);
+    $fflush(fout);
+    ob_seq++;
+  endtask
+
+  always @(negedge clk) begin
+    if (ob_pend >= 0) begin
+      flush_block(ob_pend, ob_pend_n, ob_pend_xor);
+      ob_pend = -1;
+    end
+  end
+
+  // Shared-memory transport via DPI-C; batching happens on the C side
+  bit    dpi_io = 0;
+  string shm_name;
+`ifdef COSIM_DPI
+  import "DPI-C" function int     cosim_dpi_attach(input string name);
+  import "DPI-C" function longint cosim_dpi_count();
+  import "DPI-C" function int     cosim_dpi_width();
+  import "DPI-C" function int     cosim_dpi_get(output int unsigned a, output int unsigned b);
+  import "DPI-C" function void    cosim_dpi_put(input int unsigned sum);
+  import "DPI-C" function void    cosim_dpi_flush();
+`endif
+
+  // Next operand pair from whichever source is open, in zero time; 0 at the end
+  function automatic bit next_item(output logic [W-1:0] na, output logic [W-1:0] nb);
+    if (n_total >= 0 && n_fetched >= n_total) return 0;
+`ifdef COSIM_DPI
+    if (dpi_io) begin
+      int unsigned da, db;
+      if (!cosim_dpi_get(da, db))
+        $fatal(1, "[TB] host stopped after %0d of %0d records", n_fetched, n_total);
+      na = da;
+      nb = db;
+      n_fetched++;
+      return 1;
+    end
+`endif
+    if (bin_io) begin
+      if (rb_pos == rb_cnt) begin
+        // Refill: one $fread per CHUNK records
+        rb_cnt = (n_total - n_fetched < CHUNK) ? int'(n_total - n_fetched) : CHUNK;
+        rb_pos = 0;
+        r = $fread(rbuf, fin, 0, rb_cnt * 2 * NB);
+        if (r != rb_cnt * 2 * NB)
+          $fatal(1, "[TB] %s truncated after %0d of %0d records", in_path, n_fetched, n_total);
+      end
+      na = rbuf_le(2 * NB * rb_pos);
+      nb = rbuf_le(2 * NB * rb_pos + NB);
+      rb_pos++;
+      n_fetched++;
+      return 1;
+    end
+    // Text: next "%h %h" line, skipping blanks/comments/garbage
+    while (!$feof(fin)) begin
+      r = $fscanf(fin, "%h %h\n", na, nb);
+      if (r == 2) begin
+        n_fetched++;
+        return 1;
+      end
+      void'($fgets(line, fin));
+    end
+    return 0;
+  endfunction
+
   // Consumer: write when a transfer completes (respect reset)
   always @(posedge clk) begin
     if (rst_n && out_valid && out_ready) begin
-      $fwrite(fout, "%08h\n", out_sum);
+`ifdef COSIM_DPI
+      if (dpi_io) cosim_dpi_put(out_sum); else
+`endif
+      if (blk_io) begin
+        obuf[ob_cur][ob_fill] = 32'(out_sum);
+        ob_xor ^= 32'(out_sum);
+        if (++ob_fill == OBLK) begin
+          if (ob_pend >= 0) $fatal(1, "[TB] output block %0d not flushed in time", ob_seq);
+          ob_pend     = ob_cur;
+          ob_pend_n   = OBLK;
+          ob_pend_xor = ob_xor;
+          ob_cur ^= 1;
+          ob_fill = 0;
+          ob_xor  = '0;
+        end
+      end
+      else if (bin_io) for (int k = 0; k < NB; k++) $fwrite(fout, "%c", 8'(out_sum >> (8 * k)));
+      else             $fwrite(fout, "%08h\n", out_sum);
       n_written++;
+      // Hand sums to a streaming host in chunks rather than at $fclose
+      if (bin_io && !blk_io && n_written % CHUNK == 0) $fflush(fout);
     end
   end
 
+  // Optional backpressure: redraw out_ready every cycle (updates after the
+  // edge, so DUT and consumer both see the value that was current at it)
+  always @(posedge clk) begin
+    if (ready_pct < 100) out_ready <= ($urandom_range(99) < ready_pct);
+  end
+
   // Producer: send one item, holding until accepted at a posedge
   task automatic send_item(input logic [W-1:0] a, input logic [W-1:0] b);
     @(negedge clk);
@@ -87,6 +245,24 @@ module adder_cosim_tb;
     in_valid <= 1'b0;
   endtask
 
+  // Back-to-back producer: in_valid stays high while items remain. The item
+  // after the current one is fetched right after the edge that accepts it and
+  // driven with a nonblocking update, so a ready DUT takes one per cycle.
+  task automatic drive_stream();
+    logic [W-1:0] na, nb;
+    bit have = next_item(na, nb);
+    @(negedge clk);
+    while (have) begin
+      in_a     <= na;
+      in_b     <= nb;
+      in_valid <= 1'b1;
+      do @(posedge clk); while (!in_ready);
+      n_sent++;
+      have = next_item(na, nb);
+    end
+    in_valid <= 1'b0;
+  endtask
+
   // Main control (single initial block; all statements kept inside)
   initial begin
     // Defaults
@@ -95,39 +271,89 @@ module adder_cosim_tb;
     in_b      = '0;
     out_ready = 1'b1;
 
-    // Optional plusargs to override file paths
+    // Optional plusargs to override file paths / driver behaviour
     void'($value$plusargs("cosim_inputs=%s",  in_path));
     void'($value$plusargs("cosim_outputs=%s", out_path));
+    void'($value$plusargs("cosim_drive=%s", drive));
+    void'($value$plusargs("cosim_ready_pct=%d", ready_pct));
+    if ($value$plusargs("cosim_out_blocks=%d", r)) blk_io = (r != 0);
+    if (drive != "stream" && drive != "item") $fatal(1, "[TB] +cosim_drive=%s: use stream or item", drive);
 
     // Reset sequence
     repeat (4) @(posedge clk);
     rst_n = 1'b1;
     @(posedge clk);
 
-    // Open files
-    fin  = $fopen(in_path,  "r");
-    if (fin == 0) $fatal(1, "[TB] Cannot open input %s", in_path);
-    fout = $fopen(out_path, "w");
-    if (fout == 0) $fatal(1, "[TB] Cannot open output %s", out_path);
+`ifdef COSIM_DPI
+    if ($value$plusargs("cosim_shm=%s", shm_name)) begin
+      if (cosim_dpi_attach(shm_name) != 0) $fatal(1, "[TB] Cannot attach shm %s", shm_name);
+      if (cosim_dpi_width() != W)
+        $fatal(1, "[TB] %s: width %0d, expected %0d", shm_name, cosim_dpi_width(), W);
+      dpi_io   = 1;
+      out_path = shm_name;
+      n_total  = cosim_dpi_count();
+    end
+`endif
 
-    // Read lines and drive
-    while (!$feof(fin)) begin
-      r = $fscanf(fin, "%h %h\n", a, b);
-      if (r == 2) begin
+    if (!dpi_io) begin
+      // Open files; "ADDB" as the first 4 bytes marks a binary vector file,
+      // anything else is text and is re-read from the start
+      fin  = $fopen(in_path,  "rb");
+      if (fin == 0) $fatal(1, "[TB] Cannot open input %s", in_path);
+      r = $fread(hdr, fin);
+      bin_io = (r == 16 && {hdr[0], hdr[1], hdr[2], hdr[3]} == "ADDB");
+      if (!bin_io) void'($fseek(fin, 0, 0));
+      fout = $fopen(out_path, bin_io ? "wb" : "w");
+      if (fout == 0) $fatal(1, "[TB] Cannot open output %s", out_path);
+
+      if (bin_io) begin
+        if (hdr_le(4, 2) != 1 || hdr_le(6, 2) != W)
+          $fatal(1, "[TB] %s: unsupported header (version %0d, width %0d, expected 1, %0d)",
+                 in_path, hdr_le(4, 2), hdr_le(6, 2), W);
+        n_total = hdr_le(8, 8);
+        // Output header: same count, sums are expected for every input;
+        // version 2 = blocked sums
+        $fwrite(fout, "ADDS");
+        put_le(blk_io ? 2 : 1, 2);
+        put_le(W, 2);
+        put_le(n_total, 8);
+        if (blk_io) $fflush(fout);
+      end
+    end
+    if (blk_io && !bin_io) $fatal(1, "[TB] +cosim_out_blocks needs binary vector files");
+    if (blk_io && W > 32)  $fatal(1, "[TB] +cosim_out_blocks stores 32-bit sums, W=%0d", W);
+
+    // Drive every item
+    t_start = $time;
+    if (drive == "item") begin
+      while (next_item(a, b)) begin
         send_item(a, b);
         n_sent++;
-      end else begin
-        // consume the rest of the line (skip blanks/comments/garbage)
-        void'($fgets(line, fin));
       end
+    end else begin
+      drive_stream();
     end
-    $fclose(fin);
+    if (!dpi_io) $fclose(fin);
 
     // Drain: wait until all outputs have been written
     wait (n_written == n_sent);
     @(posedge clk);
+    if (blk_io) begin
+      // The block handed over last, then the partial one
+      if (ob_pend >= 0) begin
+        flush_block(ob_pend, ob_pend_n, ob_pend_xor);
+        ob_pend = -1;
+      end
+      if (ob_fill > 0) flush_block(ob_cur, ob_fill, ob_xor);
+    end
+    n_cycles = ($time - t_start) / 10;
 
-    $display("[TB] DONE sent=%0d written=%0d -> %s", n_sent, n_written, out_path);
+    $display("[TB] DONE sent=%0d written=%0d cycles=%0d (%0.2f/item, drive=%s, ready=%0d%%) -> %s",
+             n_sent, n_written, n_cycles, n_sent ? real'(n_cycles) / n_sent : 0.0,
+             drive, ready_pct, out_path);
+`ifdef COSIM_DPI
+    if (dpi_io) cosim_dpi_flush(); else
+`endif
     $fclose(fout);
     $finish;
   end
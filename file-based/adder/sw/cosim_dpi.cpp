@@ -0,0 +1,99 @@
+// cosim_dpi.cpp
+// DPI-C side of the shared-memory transport (see cosim_shm.h), loaded into
+// vsim with -sv_lib. Only plain C types cross the DPI boundary, so no
+// svdpi.h is needed:
+//   string -> const char*,  longint -> long long,
+//   int unsigned -> unsigned int (output: unsigned int*)
+//
+// Build (done by the Makefile when DPI=1):
+//   g++ -O2 -std=c++17 -fPIC -shared -o cosim_dpi.so cosim_dpi.cpp
+#include "cosim_shm.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+CosimShm* g        = nullptr;
+uint64_t  in_pos   = 0;     // next input record
+uint64_t  in_end   = 0;     // end of the batch taken from the host
+uint64_t  out_pos  = 0;     // next output slot
+uint64_t  out_pub  = 0;     // outputs already published
+uint64_t  out_room = 0;     // output slots known to be free up to here
+
+void publish_out() {
+    if (out_pub == out_pos) return;
+    g->out_tail.store(out_pos, std::memory_order_release);
+    out_pub = out_pos;
+}
+
+} // namespace
+
+extern "C" {
+
+// Map the host's shm object; 0 on success
+int cosim_dpi_attach(const char* name) {
+    const int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) { std::fprintf(stderr, "[DPI] shm_open %s: %s\n", name, std::strerror(errno)); return -1; }
+    struct stat st;
+    void* p = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(CosimShm))
+        p = mmap(nullptr, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED) { std::fprintf(stderr, "[DPI] cannot map %s\n", name); return -1; }
+
+    CosimShm* s = static_cast<CosimShm*>(p);
+    if (s->magic != kShmMagic || s->version != kShmVersion
+        || (size_t)st.st_size < shm_bytes(s->ring)) {
+        std::fprintf(stderr, "[DPI] %s is not a v%u cosim shm object\n", name, (unsigned)kShmVersion);
+        munmap(p, (size_t)st.st_size);
+        return -1;
+    }
+    g = s;
+    in_pos = in_end = out_pos = out_pub = 0;
+    out_room = g->ring;
+    return 0;
+}
+
+long long cosim_dpi_count() { return g ? (long long)g->count : -1; }
+int       cosim_dpi_width() { return g ? (int)g->width : -1; }
+
+// Next {a, b}; 0 if the host aborted before providing it
+int cosim_dpi_get(unsigned int* a, unsigned int* b) {
+    if (in_pos == in_end) {
+        // Hand the finished batch back, push our outputs, then take the next batch
+        g->in_head.store(in_pos, std::memory_order_release);
+        publish_out();
+        if (!shm_wait(g, [] { return (in_end = g->in_tail.load(std::memory_order_acquire)) != in_pos; }))
+            return 0;
+    }
+    const uint32_t* r = shm_in(g) + 2 * (size_t)(in_pos & (g->ring - 1));
+    *a = r[0];
+    *b = r[1];
+    ++in_pos;
+    return 1;
+}
+
+// Queue one sum; published every kShmBatch sums and by cosim_dpi_flush()
+void cosim_dpi_put(unsigned int sum) {
+    if (out_pos == out_room) {
+        publish_out();
+        shm_wait(g, [] { return (out_room = g->out_head.load(std::memory_order_acquire) + g->ring) != out_pos; });
+        if (out_pos == out_room) return;           // host gone; drop
+    }
+    shm_out(g)[out_pos & (g->ring - 1)] = sum;
+    if (++out_pos - out_pub >= kShmBatch) publish_out();
+}
+
+void cosim_dpi_flush() {
+    if (!g) return;
+    g->in_head.store(in_pos, std::memory_order_release);
+    publish_out();
+}
+
+} // extern "C"
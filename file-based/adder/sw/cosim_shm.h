@@ -0,0 +1,60 @@
+// cosim_shm.h
+// Shared-memory transport between cosim_tb (host) and the SV harness, via
+// the DPI-C functions in cosim_dpi.cpp.
+//
+// One POSIX shm object per vsim run holds a header and two single-producer /
+// single-consumer rings of fixed-width records:
+//   in  ring: host -> SV, {a, b} per record
+//   out ring: SV -> host, sum per record
+// Each side copies a whole batch before publishing its index (release) and
+// reads the other side's index once per batch (acquire).
+// No text, no files, and one cache-line handoff per batch rather than per record.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <time.h>
+
+static constexpr uint32_t kShmMagic   = 0x4d444441u;   // "ADDM" little-endian
+static constexpr uint16_t kShmVersion = 1;
+static constexpr uint32_t kShmRing    = 1u << 16;      // records per ring (power of two)
+static constexpr uint32_t kShmBatch   = 4096;          // records per handoff
+
+struct CosimShm {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t width;                  // operand width in bits
+    uint64_t count;                  // records in this run
+    uint32_t ring;                   // records per ring
+
+    alignas(64) std::atomic<uint64_t> in_head;    // records consumed by SV
+    alignas(64) std::atomic<uint64_t> in_tail;    // records published by the host
+    alignas(64) std::atomic<uint64_t> out_head;   // sums consumed by the host
+    alignas(64) std::atomic<uint64_t> out_tail;   // sums published by SV
+    alignas(64) std::atomic<uint32_t> abort;      // set when either side gives up
+};
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "shared-memory indices must be lock-free to work across processes");
+
+// Ring storage follows the header
+inline uint32_t* shm_in(CosimShm* g) {
+    return reinterpret_cast<uint32_t*>(reinterpret_cast<char*>(g) + sizeof(CosimShm));
+}
+inline uint32_t* shm_out(CosimShm* g) { return shm_in(g) + 2 * (size_t)g->ring; }
+inline size_t    shm_bytes(uint32_t ring) { return sizeof(CosimShm) + 3 * sizeof(uint32_t) * (size_t)ring; }
+
+// Spin, then yield, then sleep until ready(). Returns false if the other side
+// aborted and ready() is still false.
+template <class Pred>
+inline bool shm_wait(const CosimShm* g, Pred ready) {
+    for (unsigned spin = 0;; ++spin) {
+        if (ready()) return true;
+        if (g->abort.load(std::memory_order_acquire)) return ready();
+        if (spin < 256) continue;
+        if (spin < 4096) { std::this_thread::yield(); continue; }
+        const timespec ts{0, 50 * 1000};
+        nanosleep(&ts, nullptr);
+    }
+}
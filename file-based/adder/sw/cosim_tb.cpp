@@ -2,10 +2,41 @@
 // File-based co-simulation host for Questa/ModelSim.
 // Generates inputs, compiles & runs the SV harness, then compares outputs.
 //
+// Run:
+//   ./cosim_tb [--n=N] [--seed=S] [--shards=K] [--vectors=FILE] [--rebuild] [+plusarg...]
+//   (defaults: COSIM_N, COSIM_SEED, 1). "+..." arguments are passed to every
+//   vsim run, e.g. +cosim_drive=item or +cosim_ready_pct=50.
+//
+// --vectors=FILE replays the operands of an existing binary input file (for
+// example a failing window cut out of a Verilator +txlog by txlog_replay) or
+// of an ADDV golden vector store (bench/vecstore.h, checked against its sum
+// column) instead of the LCG stream; N is then the file's record count. The
+// file is mapped, not loaded, so every shard reads its slice straight from
+// the page cache.
+//
+// Stimulus comes from an LCG on demand and every output is compared as soon
+// as it is read, so host memory is O(chunk) whatever N is.
+//
+// Vector paths reach the harness as vsim plusargs, so the compiled work
+// library does not depend on them. It is reused as long as a hash of the
+// RTL/TB sources and the vlog command line matches the key stored next to it
+// (WORKDIR/work.key); --rebuild forces vlib/vlog.
+//
+// --shards=K splits the N vectors into K contiguous slices and runs K vsim
+// processes at once from that one library, each in WORKDIR/shard<i> with its
+// own vector files. Shard i's LCG is jumped ahead to its slice, so the stream
+// and the index of every mismatch are the same as in a single run.
+//
+// COSIM_DPI=1 replaces the vector files with shared memory: the host fills a
+// ring of {a, b} records and drains a ring of sums (cosim_shm.h), and the
+// harness reaches them through the DPI-C functions in cosim_dpi.so, so no
+// disk I/O or text formatting sits on the critical path. Files stay the
+// portable default.
+//
 // Build (defaults):
 //   g++ -O2 -std=c++17 -o cosim_tb cosim_tb.cpp
 //
-// Override examples:
+// Override examples (COSIM_N / COSIM_SEED are the defaults for --n / --seed):
 //   g++ -O2 -std=c++17 -o cosim_tb cosim_tb.cpp \
 //       -DCOSIM_N=4096 -DCOSIM_SEED=7 \
 //       -DCOSIM_RTL_PATH=\"../rtl/adder_rv_simple.sv\" \
@@ -13,18 +44,52 @@
 //       -DCOSIM_INPUT_FILE=\"./inputs.txt\" \
 //       -DCOSIM_OUTPUT_FILE=\"./outputs.txt\" \
 //       -DCOSIM_WORKDIR=\"./.cosim_q\" \
-//       -DCOSIM_VLOG=\"vlog\" -DCOSIM_VSIM=\"vsim\"
+//       -DCOSIM_VLOG=\"vlog\" -DCOSIM_VSIM=\"vsim\" \
+//       -DCOSIM_TEXT_IO=1 (or -DCOSIM_STREAM=1)
+//
+// Vector files are packed binary by default (see "Binary vector files" below);
+// COSIM_TEXT_IO=1 switches to the human-readable hex text format for debugging.
+// The SV harness detects the format from the input file's header.
+//
+// COSIM_STREAM=1 makes both vector paths named pipes: a producer thread writes
+// stimulus while vsim reads it and a checker thread compares sums as the
+// harness emits them, so generation, simulation and checking overlap and no
+// vectors ever touch the disk. Streaming needs the binary format.
+//
+// COSIM_BLOCKS=1 keeps plain files but has the harness write its sums in
+// fixed-size blocks (+cosim_out_blocks=1, ADDS v2 below), one $fwrite per
+// block; a checker thread per shard tails the output file and checks each
+// block as soon as it is complete. Checking overlaps simulation, the
+// simulator never waits for the host, and when a long run dies every block
+// it finished has already been checked.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <cerrno>
+#include <csignal>
 #include <cstdint>
 #include <cstdio>
-#include <cstdlib>  // std::system
+#include <cstdlib>
+#include <cstring>
+#include <charconv>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <vector>
-#include <fstream>
 #include <sstream>
-#include <iomanip>
 #include <iostream>
 #include <filesystem>
+#include <memory>
+#include <fcntl.h>      // open (FIFO unblocking), shm_open
+#include <sys/mman.h>   // mmap
+#include <sys/stat.h>   // mkfifo
 #include <sys/wait.h>   // WIFEXITED, WEXITSTATUS
+#include <spawn.h>      // posix_spawn, per-child chdir
+#include <unistd.h>     // environ
+
+#include "cosim_shm.h"
+#include "vecstore.h"
 
 #ifndef COSIM_N
 #  define COSIM_N 1024
@@ -38,11 +103,42 @@
 #ifndef COSIM_TB_PATH
 #  define COSIM_TB_PATH "../rtl/adder_cosim_tb.sv"
 #endif
+#ifndef COSIM_TEXT_IO
+#  define COSIM_TEXT_IO 0
+#endif
+#ifndef COSIM_STREAM
+#  define COSIM_STREAM 0
+#endif
+#ifndef COSIM_DPI
+#  define COSIM_DPI 0
+#endif
+#ifndef COSIM_BLOCKS
+#  define COSIM_BLOCKS 0
+#endif
+#ifndef COSIM_DPI_LIB
+#  define COSIM_DPI_LIB "./cosim_dpi"      // vsim -sv_lib path, without .so
+#endif
+#if COSIM_STREAM && COSIM_TEXT_IO
+#  error "COSIM_STREAM needs the binary vector format (COSIM_TEXT_IO=0)"
+#endif
+#if COSIM_DPI && (COSIM_STREAM || COSIM_TEXT_IO)
+#  error "COSIM_DPI replaces the vector files (COSIM_STREAM=0, COSIM_TEXT_IO=0)"
+#endif
+#if COSIM_BLOCKS && (COSIM_STREAM || COSIM_TEXT_IO || COSIM_DPI)
+#  error "COSIM_BLOCKS tails a binary output file (COSIM_STREAM=0, COSIM_TEXT_IO=0, COSIM_DPI=0)"
+#endif
+#if COSIM_STREAM
+#  define COSIM_VEC_EXT "fifo"
+#elif COSIM_TEXT_IO
+#  define COSIM_VEC_EXT "txt"
+#else
+#  define COSIM_VEC_EXT "bin"
+#endif
 #ifndef COSIM_INPUT_FILE
-#  define COSIM_INPUT_FILE "./inputs.txt"
+#  define COSIM_INPUT_FILE "./inputs." COSIM_VEC_EXT
 #endif
 #ifndef COSIM_OUTPUT_FILE
-#  define COSIM_OUTPUT_FILE "./outputs.txt"
+#  define COSIM_OUTPUT_FILE "./outputs." COSIM_VEC_EXT
 #endif
 #ifndef COSIM_WORKDIR
 #  define COSIM_WORKDIR "./.cosim_q"
@@ -54,70 +150,517 @@
 #  define COSIM_VSIM "vsim"
 #endif
 
+// Run `cmd` through /bin/sh -c in `cwd` without touching our own cwd, so
+// several children can run at once. Returns the pid, or -1 on error.
+static pid_t spawn_cmd(const std::string& cmd, const std::filesystem::path& cwd) {
+    posix_spawn_file_actions_t fa;
+    posix_spawn_file_actions_init(&fa);
+    posix_spawn_file_actions_addchdir_np(&fa, cwd.c_str());
+    const char* argv[] = {"sh", "-c", cmd.c_str(), nullptr};
+    pid_t pid = -1;
+    const int err = posix_spawn(&pid, "/bin/sh", &fa, nullptr, const_cast<char**>(argv), environ);
+    posix_spawn_file_actions_destroy(&fa);
+    return err == 0 ? pid : -1;
+}
+
+// Exit code of a spawned child; 128+signal if it was killed
+static int wait_cmd(pid_t pid) {
+    if (pid < 0) return -1;
+    int status = 0;
+    while (waitpid(pid, &status, 0) < 0)
+        if (errno != EINTR) return -1;
+    if (WIFEXITED(status))  return WEXITSTATUS(status);
+    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
+    return status;                               // fallback
+}
+
 static int run_cmd(const std::string& cmd, const std::filesystem::path& cwd) {
-    namespace fs = std::filesystem;
+    return wait_cmd(spawn_cmd(cmd, cwd));
+}
 
-    const fs::path prev = fs::current_path();   // remember current dir
-    int status = -1;
+// Same operand stream for the generator and the checker, so nothing has to
+// be kept between writing the inputs and reading the outputs
+struct Lcg {
+    static constexpr uint32_t kA = 1664525u, kC = 1013904223u;
+    uint32_t s;
+    const VecStore* tape = nullptr;   // --vectors: recorded operands instead of the LCG
+    uint64_t pos = 0;                 // next operand of the tape: a, b of vector pos/2
+    uint32_t next() {
+        if (tape) {
+            const uint64_t i = pos++;
+            return (uint32_t)(i & 1 ? tape->b(i >> 1) : tape->a(i >> 1));
+        }
+        s = s * kA + kC;
+        return s;
+    }
 
-    try {
-        fs::current_path(cwd);                  // cd to target
-        status = std::system(cmd.c_str());      // run through /bin/sh -c
-        fs::current_path(prev);                 // cd back
-    } catch (...) {
-        // best effort to restore, then rethrow
-        std::error_code ec;
-        fs::current_path(prev, ec);
-        throw;
+    // Generator after `steps` calls to next(), in O(log steps): lets a shard
+    // start at its own slice of the serial stream
+    static Lcg at(uint32_t seed, uint64_t steps, const VecStore* tape = nullptr) {
+        if (tape) return Lcg{0, tape, steps};
+        uint32_t acc_a = 1, acc_c = 0, a = kA, c = kC;
+        for (; steps; steps >>= 1) {
+            if (steps & 1) { acc_a *= a; acc_c = acc_c * a + c; }
+            c *= a + 1;
+            a *= a;
+        }
+        return Lcg{acc_a * seed + acc_c};
     }
+};
 
-    if (status == -1) return -1;                // system() failed
-    if (WIFEXITED(status))  return WEXITSTATUS(status);
-    if (WIFSIGNALED(status)) return 128 + WTERMSIG(status);
-    return status;                               // fallback
+static constexpr size_t kChunk = 1u << 16;      // records per write()/read()
+
+// Binary vector files: 16-byte header, then fixed-width little-endian records
+//   0  char[4]  magic    "ADDB" (inputs: a, b) / "ADDS" (outputs: sum)
+//   4  u16      version  1
+//   6  u16      width    operand width in bits
+//   8  u64      count    number of records
+//  16  records           (width+7)/8 bytes per field, a then b for inputs
+// ADDS version 2 (COSIM_BLOCKS) replaces the records with blocks of
+// kBlkRecs sums, each behind a 16-byte block header:
+//   0  u32  sync   "SBLK"
+//   4  u32  seq    block number, from 0
+//   8  u32  n      valid sums in this block (< kBlkRecs only in the last)
+//  12  u32  xor    XOR of the n valid sums
+//  16  u32  sum[kBlkRecs]   (the last block is padded)
+static constexpr char     kMagicIn[4]  = {'A', 'D', 'D', 'B'};
+static constexpr char     kMagicOut[4] = {'A', 'D', 'D', 'S'};
+static constexpr uint16_t kBinVersion  = 1;
+static constexpr uint16_t kBlkVersion  = 2;
+static constexpr uint32_t kBlkSync     = 0x4B4C4253u;   // "SBLK"
+static constexpr size_t   kBlkRecs     = 1024;          // adder_cosim_tb.sv OBLK
+static constexpr size_t   kBlkBytes    = 16 + 4 * kBlkRecs;
+static constexpr unsigned kWidth       = 32;
+static constexpr size_t   kHdrBytes    = 16;
+
+static void put_le(unsigned char* p, uint64_t v, unsigned nbytes) {
+    for (unsigned i = 0; i < nbytes; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+static uint64_t get_le(const unsigned char* p, unsigned nbytes) {
+    uint64_t v = 0;
+    for (unsigned i = nbytes; i-- > 0; ) v = (v << 8) | p[i];
+    return v;
 }
 
-static bool write_inputs_txt(const std::filesystem::path& path,
-                             const std::vector<std::pair<uint32_t,uint32_t>>& vec) {
-    std::ofstream ofs(path);
-    if (!ofs) return false;
-    // Sets the stream's base to hexadecimal for all subsequent integer writes
-    ofs.setf(std::ios::hex, std::ios::basefield);
-    for (auto [a,b] : vec) {
-        // std::noshowbase → don't print 0x prefix.
-        // std::nouppercase → hex letters are lowercase (a..f).
-        // std::setw(8) + std::setfill('0') → each number is exactly 8 hex digits,
-        // zero-padded on the left.
-        ofs << std::noshowbase << std::nouppercase
-            << std::setw(8) << std::setfill('0') << a << ' '
-            << std::setw(8) << std::setfill('0') << b << '\n';
+static void put_header(unsigned char* p, const char (&magic)[4], uint64_t count) {
+    std::memcpy(p, magic, 4);
+    put_le(p + 4, kBinVersion, 2);
+    put_le(p + 6, kWidth, 2);
+    put_le(p + 8, count, 8);
+}
+
+static bool check_out_header(const unsigned char* h, const std::filesystem::path& path,
+                             uint64_t& count, uint16_t version = kBinVersion) {
+    if (std::memcmp(h, kMagicOut, 4) != 0 || get_le(h + 4, 2) != version
+        || get_le(h + 6, 2) != kWidth) {
+        std::cerr << "[C-TB] ERROR: " << path << " is not a v" << version
+                  << " " << kWidth << "-bit output vector file\n";
+        return false;
     }
+    count = get_le(h + 8, 8);
     return true;
 }
 
-static bool read_outputs_txt(const std::filesystem::path& path,
-                                std::vector<uint32_t>& out) {
-    std::ifstream ifs(path);
-    if (!ifs) return false;
-    // discard any previous contents
-    out.clear();
-    std::string tok;
-    // Read tokens separated by any whitespace (spaces/newlines/tabs)
-    while (ifs >> tok) {
-        uint32_t v = 0;
-        // parse each token separately
-        std::stringstream ss(tok);
-        ss.setf(std::ios::hex, std::ios::basefield);
-        // interpret token as hexadecimal
-        ss >> v;
-        // On overflow (value doesn't fit in uint32_t) or malformed input,
-        // the stream sets failbit (so ss.fail() becomes true).
-        if (!ss.fail()) out.push_back(v);
+// "%08x" without printf
+static char* put_hex8(char* p, uint32_t v) {
+    static const char kDigits[] = "0123456789abcdef";
+    for (int i = 7; i >= 0; --i, v >>= 4) p[i] = kDigits[v & 15];
+    return p + 8;
+}
+
+// Text inputs: "aaaaaaaa bbbbbbbb\n" per record, formatted a chunk at a time
+static bool write_inputs_txt(const std::filesystem::path& path, Lcg lcg, uint64_t n) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::vector<char> buf(kChunk * 18);
+    bool ok = true;
+    for (uint64_t i = 0; ok && i < n; ) {
+        const size_t m = (size_t)std::min<uint64_t>(kChunk, n - i);
+        char* p = buf.data();
+        for (size_t k = 0; k < m; ++k) {
+            const uint32_t a = lcg.next();
+            const uint32_t b = lcg.next();
+            p = put_hex8(p, a); *p++ = ' ';
+            p = put_hex8(p, b); *p++ = '\n';
+        }
+        ok = std::fwrite(buf.data(), 1, (size_t)(p - buf.data()), f) == (size_t)(p - buf.data());
+        i += m;
+    }
+    return std::fclose(f) == 0 && ok;
+}
+
+// Binary inputs, generated and written a chunk at a time (file or FIFO)
+static bool write_inputs_bin(const std::filesystem::path& path, Lcg lcg, uint64_t n) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) return false;
+    std::vector<unsigned char> buf(kChunk * 8);
+    put_header(buf.data(), kMagicIn, n);
+    bool ok = std::fwrite(buf.data(), 1, kHdrBytes, f) == kHdrBytes;
+
+    for (uint64_t i = 0; ok && i < n; ) {
+        const size_t m = (size_t)std::min<uint64_t>(kChunk, n - i);
+        for (size_t k = 0; k < m; ++k) {
+            const uint32_t a = lcg.next();
+            const uint32_t b = lcg.next();
+            put_le(&buf[8 * k],     a, 4);
+            put_le(&buf[8 * k + 4], b, 4);
+        }
+        ok = std::fwrite(buf.data(), 8, m, f) == m;
+        i += m;
     }
+    return std::fclose(f) == 0 && ok;
+}
+
+// --vectors: map an ADDB input file or an ADDV golden store (vecstore.h);
+// operands and golden sums are read from the mapping as they are needed
+static bool open_vectors(const std::filesystem::path& path, VecStore& st) {
+    std::string err;
+    if (!st.open(path.string(), &err)) {
+        std::cerr << "[C-TB] ERROR: " << err << "\n";
+        return false;
+    }
+    if (st.width() != kWidth) {
+        std::cerr << "[C-TB] ERROR: " << path << " has " << st.width() << "-bit operands, this harness "
+                  << kWidth << "\n";
+        return false;
+    }
+    if (st.has_valid() || st.has_ready())
+        std::cout << "[C-TB] note: " << path << " has valid/ready schedules; this harness uses "
+                  << "+cosim_drive / +cosim_ready_pct instead\n";
     return true;
 }
 
-int main() {
+// Compares each output against a replica of the generator's LCG as it is
+// read; keeps the first few mismatches for the report
+class Checker {
+public:
+    struct Mismatch { uint64_t index; uint32_t a, b, got, exp; };
+    static constexpr size_t kKeep = 10;
+
+    Checker(Lcg lcg, uint64_t first) : m_lcg(lcg), m_index(first) {}
+
+    void check(uint32_t got) {
+        const uint32_t a = m_lcg.next();
+        const uint32_t b = m_lcg.next();
+        const VecStore* st = m_lcg.tape;
+        const uint32_t exp = st && st->has_sum() ? (uint32_t)st->sum(m_index + m_seen)
+                                                 : (uint32_t)((uint64_t)a + (uint64_t)b);
+        if (got != exp) {
+            if (m_log.size() < kKeep) m_log.push_back({m_index + m_seen, a, b, got, exp});
+            ++m_mism;
+        }
+        ++m_seen;
+    }
+
+    uint64_t seen() const { return m_seen; }
+    uint64_t mism() const { return m_mism; }
+    const std::vector<Mismatch>& log() const { return m_log; }
+
+private:
+    Lcg      m_lcg;
+    uint64_t m_index;           // global index of the first record
+    uint64_t m_seen = 0;
+    uint64_t m_mism = 0;
+    std::vector<Mismatch> m_log;
+};
+
+// Text outputs: whitespace-separated hex tokens, parsed in place with
+// std::from_chars; malformed or out-of-range tokens are skipped
+static bool check_outputs_txt(const std::filesystem::path& path, Checker& chk) {
+    std::FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return false;
+    std::vector<char> buf(kChunk * 9);
+    size_t keep = 0;    // bytes of a token cut off at the end of the last chunk
+    bool eof = false;
+    while (!eof) {
+        const size_t got = std::fread(buf.data() + keep, 1, buf.size() - keep, f);
+        eof = got < buf.size() - keep;
+        const char* p   = buf.data();
+        const char* end = buf.data() + keep + got;
+        for (;;) {
+            while (p < end && std::isspace((unsigned char)*p)) ++p;
+            const char* tok = p;
+            while (p < end && !std::isspace((unsigned char)*p)) ++p;
+            if (p == end && !eof) { p = tok; break; }   // token may continue in the next chunk
+            if (tok == p) break;
+            uint32_t v = 0;
+            const auto r = std::from_chars(tok, p, v, 16);
+            if (r.ec == std::errc() && r.ptr == p) chk.check(v);
+        }
+        keep = (size_t)(end - p);
+        if (keep == buf.size()) break;                   // one giant token: not ours
+        std::memmove(buf.data(), p, keep);
+    }
+    std::fclose(f);
+    return true;
+}
+
+// Binary outputs (file or FIFO): header, then sums checked a chunk at a time
+static bool check_outputs_bin(const std::filesystem::path& path, Checker& chk, uint64_t& count) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    std::vector<unsigned char> buf(kChunk * 4);
+    if (std::fread(buf.data(), 1, kHdrBytes, f) != kHdrBytes || !check_out_header(buf.data(), path, count)) {
+        std::fclose(f);
+        return false;
+    }
+    size_t m;
+    while ((m = std::fread(buf.data(), 4, kChunk, f)) > 0)
+        for (size_t k = 0; k < m; ++k) chk.check((uint32_t)get_le(&buf[4 * k], 4));
+    std::fclose(f);
+    return true;
+}
+
+// Blocked outputs (COSIM_BLOCKS), checked while vsim is still writing them:
+// whatever has reached the file is read, every complete block is checked,
+// and the rest waits for the next poll. Ends when all `count` sums are in,
+// or when `done` (vsim has exited) and the file has nothing more.
+static bool tail_outputs_blocks(const std::filesystem::path& path, Checker& chk, uint64_t& count,
+                                const std::atomic<bool>& done) {
+    using namespace std::chrono_literals;
+    constexpr auto kPoll = 20ms;
+    int fd = -1;
+    while ((fd = open(path.c_str(), O_RDONLY)) < 0) {   // vsim creates it after elaboration
+        if (done.load(std::memory_order_acquire)) return false;
+        std::this_thread::sleep_for(kPoll);
+    }
+    std::vector<unsigned char> buf(kChunk * 4 + kBlkBytes);
+    size_t have = 0;
+    bool   hdr  = false, last = false, ok = true;
+    for (uint32_t seq = 0; ok && !(hdr && (last || chk.seen() == count)); ) {
+        const bool final_read = done.load(std::memory_order_acquire);
+        const ssize_t got = read(fd, buf.data() + have, buf.size() - have);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) { ok = false; break; }
+        have += (size_t)got;
+        size_t pos = 0;
+        if (!hdr && have >= kHdrBytes) {
+            if (!(ok = check_out_header(buf.data(), path, count, kBlkVersion))) break;
+            hdr = true;
+            pos = kHdrBytes;
+        }
+        for (; hdr && have - pos >= kBlkBytes; pos += kBlkBytes, ++seq) {
+            const unsigned char* b = &buf[pos];
+            const uint32_t n = (uint32_t)get_le(b + 8, 4);
+            if (get_le(b, 4) != kBlkSync || get_le(b + 4, 4) != seq || n == 0 || n > kBlkRecs) {
+                std::cerr << "[C-TB] ERROR: " << path << ": bad block header at block " << seq << "\n";
+                ok = false;
+                break;
+            }
+            uint32_t x = 0;
+            for (uint32_t k = 0; k < n; ++k) {
+                const uint32_t v = (uint32_t)get_le(b + 16 + 4 * k, 4);
+                x ^= v;
+                chk.check(v);
+            }
+            if (x != (uint32_t)get_le(b + 12, 4)) {
+                std::cerr << "[C-TB] ERROR: " << path << ": block " << seq << " fails its XOR check\n";
+                ok = false;
+                break;
+            }
+            if (n < kBlkRecs) { last = true; pos += kBlkBytes; break; }
+        }
+        std::memmove(buf.data(), buf.data() + pos, have - pos);
+        have -= pos;
+        if (got == 0) {
+            if (final_read) break;               // vsim is gone and so is the data
+            std::this_thread::sleep_for(kPoll);
+        }
+    }
+    close(fd);
+    return ok && hdr;
+}
+
+static bool make_fifo(const std::filesystem::path& path) {
+    std::error_code ec;
+    std::filesystem::remove(path, ec);
+    if (mkfifo(path.c_str(), 0600) == 0) return true;
+    std::cerr << "[C-TB] ERROR: mkfifo " << path << ": " << std::strerror(errno) << "\n";
+    return false;
+}
+
+// Opening a FIFO end blocks until the other end is opened. If the simulator
+// died before opening its side, open and close that side here so the
+// producer/checker threads fall through instead of hanging.
+static void unblock_fifo(const std::filesystem::path& path, int flags) {
+    const int fd = open(path.c_str(), flags | O_NONBLOCK);
+    if (fd >= 0) close(fd);
+}
+
+// Host-owned shm object for one vsim run; unlinked when it goes away
+class ShmRegion {
+public:
+    ShmRegion(std::string name, uint64_t count) : m_name(std::move(name)) {
+        shm_unlink(m_name.c_str());
+        const int fd = shm_open(m_name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600);
+        if (fd < 0) return;
+        m_bytes = shm_bytes(kShmRing);
+        void* p = MAP_FAILED;
+        if (ftruncate(fd, (off_t)m_bytes) == 0)
+            p = mmap(nullptr, m_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+        if (p == MAP_FAILED) { shm_unlink(m_name.c_str()); return; }
+
+        m_shm = new (p) CosimShm{};               // fresh mapping is zero-filled
+        m_shm->magic   = kShmMagic;
+        m_shm->version = kShmVersion;
+        m_shm->width   = kWidth;
+        m_shm->count   = count;
+        m_shm->ring    = kShmRing;
+    }
+    ~ShmRegion() {
+        if (!m_shm) return;
+        munmap(m_shm, m_bytes);
+        shm_unlink(m_name.c_str());
+    }
+    ShmRegion(const ShmRegion&) = delete;
+    ShmRegion& operator=(const ShmRegion&) = delete;
+
+    CosimShm*          get()  const { return m_shm; }
+    const std::string& name() const { return m_name; }
+
+private:
+    std::string m_name;
+    CosimShm*   m_shm   = nullptr;
+    size_t      m_bytes = 0;
+};
+
+// Producer: generate n records straight into the input ring, one batch per handoff
+static bool dpi_produce(CosimShm* g, Lcg lcg, uint64_t n) {
+    uint32_t* ring = shm_in(g);
+    const uint64_t mask = g->ring - 1;
+    uint64_t free_to = g->ring;          // input slots known to be free up to here
+    for (uint64_t i = 0; i < n; ) {
+        if (i == free_to && !shm_wait(g, [&] { return (free_to = g->in_head.load(std::memory_order_acquire)
+                                                                 + g->ring) != i; }))
+            return false;
+        const uint64_t end = std::min<uint64_t>({n, free_to, i + kShmBatch});
+        for (; i < end; ++i) {
+            ring[2 * (i & mask)]     = lcg.next();
+            ring[2 * (i & mask) + 1] = lcg.next();
+        }
+        g->in_tail.store(i, std::memory_order_release);
+    }
+    return true;
+}
+
+// Checker: compare sums as the harness publishes them; false if it stopped early
+static bool dpi_check(CosimShm* g, Checker& chk, uint64_t n) {
+    const uint32_t* ring = shm_out(g);
+    const uint64_t mask = g->ring - 1;
+    uint64_t avail = 0;
+    for (uint64_t i = 0; i < n; ) {
+        if (i == avail && !shm_wait(g, [&] { return (avail = g->out_tail.load(std::memory_order_acquire)) != i; }))
+            return false;
+        for (; i < avail; ++i) chk.check(ring[i & mask]);
+        g->out_head.store(i, std::memory_order_release);
+    }
+    return true;
+}
+
+// 64-bit FNV-1a, enough to tell source revisions apart
+static uint64_t fnv1a(uint64_t h, const void* data, size_t n) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+    return h;
+}
+
+static bool hash_file(const std::filesystem::path& path, uint64_t& h) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    char buf[1 << 16];
+    size_t m;
+    while ((m = std::fread(buf, 1, sizeof buf, f)) > 0) h = fnv1a(h, buf, m);
+    std::fclose(f);
+    return true;
+}
+
+// Cache key of the work library: source contents + the exact vlog command
+static std::string compile_key(const std::vector<std::filesystem::path>& srcs,
+                               const std::string& vlog_cmd) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    for (const auto& p : srcs)
+        if (!hash_file(p, h)) return {};         // unreadable source: never a hit
+    h = fnv1a(h, vlog_cmd.data(), vlog_cmd.size());
+    char hex[17];
+    std::snprintf(hex, sizeof hex, "%016llx", (unsigned long long)h);
+    return hex;
+}
+
+static std::string read_key(const std::filesystem::path& path) {
+    std::string key;
+    std::FILE* f = std::fopen(path.c_str(), "r");
+    if (!f) return key;
+    char buf[64];
+    if (std::fgets(buf, sizeof buf, f)) key = buf;
+    std::fclose(f);
+    while (!key.empty() && std::isspace((unsigned char)key.back())) key.pop_back();
+    return key;
+}
+
+static bool write_key(const std::filesystem::path& path, const std::string& key) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    const bool ok = std::fprintf(f, "%s\n", key.c_str()) > 0;
+    return std::fclose(f) == 0 && ok;
+}
+
+// --n=N --seed=S --shards=K --vectors=FILE --rebuild +plusarg; returns false (after
+// printing usage) on anything else. Plusargs are collected, quoted, for the vsim
+// command line.
+static bool parse_args(int argc, char** argv, uint64_t& n, uint32_t& seed, unsigned& shards,
+                       std::string& vectors, bool& rebuild, std::string& plusargs) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view a = argv[i];
+        const auto num = [&](std::string_view key, auto& out) {
+            if (a.substr(0, key.size()) != key) return false;
+            const char* b = a.data() + key.size();
+            const char* e = a.data() + a.size();
+            const auto r = std::from_chars(b, e, out);
+            return b != e && r.ec == std::errc() && r.ptr == e;
+        };
+        if (num("--n=", n) || num("--seed=", seed) || num("--shards=", shards)) continue;
+        if (a == "--rebuild") { rebuild = true; continue; }
+        if (a.substr(0, 10) == "--vectors=" && a.size() > 10) { vectors = a.substr(10); continue; }
+        if (a.size() > 1 && a[0] == '+' && a.find('"') == std::string_view::npos) {
+            plusargs.append("\"").append(a).append("\" ");
+            continue;
+        }
+        std::cerr << "usage: " << argv[0] << " [--n=N] [--seed=S] [--shards=K] [--vectors=FILE] [--rebuild] [+plusarg...]"
+                  << "   (defaults " << COSIM_N << ", " << COSIM_SEED << ", 1)\n";
+        return false;
+    }
+    return true;
+}
+
+// One vsim process over a contiguous slice [first, first+n) of the vectors
+struct Shard {
+    Shard(uint32_t seed, uint64_t first_, uint64_t n_, const VecStore* tape)
+        : first(first_), n(n_), lcg(Lcg::at(seed, 2 * first_, tape)), chk(lcg, first_) {}
+
+    uint64_t first, n;
+    Lcg      lcg;                    // generator state at `first`
+    Checker  chk;
+    std::filesystem::path dir, inp, out;   // dir is the child's cwd
+    std::unique_ptr<ShmRegion> shm;  // COSIM_DPI transport
+    pid_t    pid    = -1;
+    int      rc     = -1;
+    uint64_t count  = 0;             // record count claimed by a binary output header
+    bool     sent   = false;
+    bool     ok_out = false;
+};
+
+// Run fn(shard) for every shard on its own thread and wait for all of them
+template <class Fn>
+static void for_each_shard(std::vector<Shard>& shards, Fn fn) {
+    std::vector<std::thread> th;
+    th.reserve(shards.size());
+    for (Shard& sh : shards) th.emplace_back([&fn, &sh] { fn(sh); });
+    for (std::thread& t : th) t.join();
+}
+
+int main(int argc, char** argv) {
 
     using std::filesystem::path;
     const path   RTL    = COSIM_RTL_PATH;
@@ -128,78 +671,215 @@ int main() {
     const std::string VLOG = COSIM_VLOG;
     const std::string VSIM = COSIM_VSIM;
 
+    uint64_t N      = COSIM_N;
+    uint32_t SEED   = COSIM_SEED;
+    unsigned SHARDS = 1;
+    bool     REBUILD = false;
+    std::string PLUSARGS, VECTORS;
+    if (!parse_args(argc, argv, N, SEED, SHARDS, VECTORS, REBUILD, PLUSARGS)) return 1;
+
+    VecStore TAPE;
+    if (!VECTORS.empty()) {
+        if (!open_vectors(VECTORS, TAPE)) return 2;
+        N = TAPE.count();
+        std::cout << "[C-TB] replaying " << N << " vectors from " << VECTORS << " (" << TAPE.format() << ")\n";
+        if (N == 0) return 2;
+    }
+
     std::error_code ec;
     std::filesystem::create_directories(WORK, ec);
 
-    // Stimulus
-    std::vector<std::pair<uint32_t,uint32_t>> in;
-    in.reserve(COSIM_N);
-    uint32_t s = (uint32_t)COSIM_SEED;
-    auto lcg = [&](){ s = s * 1664525u + 1013904223u; return s; };
-    for (int i = 0; i < COSIM_N; ++i) {
-        uint32_t a = lcg();
-        uint32_t b = lcg();
-        in.emplace_back(a, b);
-    }
-    if (!write_inputs_txt(INP, in)) {
-        std::cerr << "[C-TB] ERROR: cannot write " << INP << "\n";
-        return 2;
+    // Split N into K contiguous shards. A single shard uses the configured
+    // paths; otherwise shard i runs in WORK/shard<i> with its own vector files.
+    const unsigned K = (unsigned)std::max<uint64_t>(1, std::min<uint64_t>(SHARDS ? SHARDS : 1, N));
+    std::vector<Shard> shards;
+    shards.reserve(K);
+    for (unsigned i = 0; i < K; ++i) {
+        const uint64_t first = N * i / K;
+        Shard& sh = shards.emplace_back(SEED, first, N * (i + 1) / K - first,
+                                        TAPE.is_open() ? &TAPE : nullptr);
+        if (K == 1) {
+            sh.dir = WORK;
+            sh.inp = INP;
+            sh.out = OUT;
+        } else {
+            sh.dir = WORK / ("shard" + std::to_string(i));
+            sh.inp = sh.dir / INP.filename();
+            sh.out = sh.dir / OUT.filename();
+            std::filesystem::create_directories(sh.dir, ec);
+        }
+        // Paths for plusargs (absolute, the child runs in its own cwd)
+        sh.inp = std::filesystem::absolute(sh.inp);
+        sh.out = std::filesystem::absolute(sh.out);
     }
-    std::filesystem::remove(OUT, ec);
 
-    // Paths for defines (absolute, to avoid cwd confusion)
-    path abs_in  = std::filesystem::absolute(INP);
-    path abs_out = std::filesystem::absolute(OUT);
-
-    // 1) vlib work
-    if (run_cmd("vlib work", WORK) != 0) { std::cerr << "[C-TB] vlib failed\n"; return 3; }
+    // Stimulus: written up front, or produced on the fly into a FIFO / shm ring
+    if (COSIM_DPI) {
+        for (Shard& sh : shards) {
+            const std::string name = "/cosim_tb." + std::to_string(getpid()) + "."
+                                   + std::to_string(&sh - shards.data());
+            sh.shm = std::make_unique<ShmRegion>(name, sh.n);
+            if (!sh.shm->get()) {
+                std::cerr << "[C-TB] ERROR: cannot create shm " << name << ": " << std::strerror(errno) << "\n";
+                return 2;
+            }
+        }
+    } else if (COSIM_STREAM) {
+        for (Shard& sh : shards)
+            if (!make_fifo(sh.inp) || !make_fifo(sh.out)) return 2;
+    } else {
+        for_each_shard(shards, [](Shard& sh) {
+            sh.sent = COSIM_TEXT_IO ? write_inputs_txt(sh.inp, sh.lcg, sh.n)
+                                    : write_inputs_bin(sh.inp, sh.lcg, sh.n);
+        });
+        for (Shard& sh : shards) {
+            if (!sh.sent) {
+                std::cerr << "[C-TB] ERROR: cannot write " << sh.inp << "\n";
+                return 2;
+            }
+            std::filesystem::remove(sh.out, ec);
+        }
+    }
 
-    // 2) vlog: compile RTL + TB, injecting macros for input/output file paths
+    // 1+2) vlib work + vlog RTL + TB, skipped when the cached library is current
     std::stringstream vlog_cmd;
-    vlog_cmd << VLOG << " -sv "
-             << "+define+COSIM_INPUTS="  << '\"' << abs_in.string()  << '\"' << ' '
-             << "+define+COSIM_OUTPUTS=" << '\"' << abs_out.string() << '\"' << ' '
+    vlog_cmd << VLOG << " -sv " << (COSIM_DPI ? "+define+COSIM_DPI " : "")
              << '\"' << std::filesystem::absolute(RTL).string() << '\"' << ' '
              << '\"' << std::filesystem::absolute(TB).string()  << '\"';
-    if (run_cmd(vlog_cmd.str(), WORK) != 0) { std::cerr << "[C-TB] vlog failed\n"; return 3; }
-
-    // 3) vsim: run batch
-    std::stringstream vsim_cmd;
-    vsim_cmd << VSIM << " -c work.adder_cosim_tb -do " << '\"' << "run -all; quit -f" << '\"';
-    if (run_cmd(vsim_cmd.str(), WORK) != 0) { std::cerr << "[C-TB] vsim failed\n"; return 3; }
-
-    // 4) Compare
-    std::vector<uint32_t> got;
-    if (!read_outputs_txt(OUT, got)) {
-        std::cerr << "[C-TB] ERROR: cannot read " << OUT << "\n";
-        return 4;
-    }
-    if ((int)got.size() != COSIM_N) {
-        std::cerr << "[C-TB] ERROR: length mismatch outputs=" << got.size()
-                  << " inputs=" << COSIM_N << "\n";
-        return 4;
-    }
-
-    size_t mism = 0;
-    for (int i = 0; i < COSIM_N; ++i) {
-        uint32_t exp = (uint32_t)((uint64_t)in[i].first + (uint64_t)in[i].second);
-        if (got[i] != exp) {
-            if (mism < 10) {
-                std::cerr << "MISMATCH @" << i
-                          << " a=" << std::hex << std::uppercase << in[i].first
-                          << " b=" << in[i].second
-                          << " out=" << got[i]
-                          << " exp=" << exp << std::dec << "\n";
-            }
-            ++mism;
+    const path        KEY = WORK / "work.key";
+    const std::string key = compile_key({RTL, TB}, vlog_cmd.str());
+    if (!REBUILD && !key.empty() && std::filesystem::is_directory(WORK / "work")
+        && read_key(KEY) == key) {
+        std::cout << "[C-TB] work library up to date (" << key << "), skipping vlog\n";
+    } else {
+        std::filesystem::remove(KEY, ec);       // no stale hit if the compile fails
+        if (run_cmd("vlib work", WORK) != 0) { std::cerr << "[C-TB] vlib failed\n"; return 3; }
+        if (run_cmd(vlog_cmd.str(), WORK) != 0) { std::cerr << "[C-TB] vlog failed\n"; return 3; }
+        if (!key.empty() && !write_key(KEY, key))
+            std::cerr << "[C-TB] WARNING: cannot write " << KEY << "\n";
+    }
+
+    // 3) vsim: K batch runs at once, all from the one compiled library; vector
+    //    paths go in as plusargs
+    const path abs_lib = std::filesystem::absolute(WORK / "work");
+    if (K > 1) std::cout << "[C-TB] " << K << " vsim shards of ~" << N / K << " vectors\n";
+    if (COSIM_STREAM) std::signal(SIGPIPE, SIG_IGN);   // a dead simulator shows up as a write error
+    const path abs_dpi = std::filesystem::absolute(COSIM_DPI_LIB);
+    for (Shard& sh : shards) {
+        std::stringstream vsim_cmd;
+        vsim_cmd << VSIM << " -c -lib " << '\"' << abs_lib.string() << '\"' << " adder_cosim_tb ";
+        if (COSIM_DPI)
+            vsim_cmd << "-sv_lib " << '\"' << abs_dpi.string() << '\"' << ' '
+                     << "+cosim_shm=" << sh.shm->name() << ' ';
+        else
+            vsim_cmd << '\"' << "+cosim_inputs="  << sh.inp.string() << '\"' << ' '
+                     << '\"' << "+cosim_outputs=" << sh.out.string() << '\"' << ' '
+                     << (COSIM_BLOCKS ? "+cosim_out_blocks=1 " : "");
+        vsim_cmd << PLUSARGS << "-do " << '\"' << "run -all; quit -f" << '\"';
+        sh.pid = spawn_cmd(vsim_cmd.str(), sh.dir);
+    }
+
+    // 4) Compare each output as it is read; memory is O(chunk) per shard
+    if (COSIM_DPI) {
+        // Host threads fill/drain the rings while vsim runs
+        std::vector<std::thread> io;
+        for (Shard& sh : shards) {
+            if (sh.pid < 0) continue;
+            CosimShm* g = sh.shm->get();
+            io.emplace_back([&sh, g] { sh.sent   = dpi_produce(g, sh.lcg, sh.n); });
+            io.emplace_back([&sh, g] { sh.ok_out = dpi_check(g, sh.chk, sh.n); sh.count = sh.chk.seen(); });
+        }
+        for (Shard& sh : shards) {
+            sh.rc = wait_cmd(sh.pid);
+            // Whatever vsim published is still drained; then the threads stop
+            sh.shm->get()->abort.store(1, std::memory_order_release);
+        }
+        for (std::thread& t : io) t.join();
+    } else if (COSIM_STREAM) {
+        // Generation, simulation and checking overlap
+        std::vector<std::thread> io;
+        for (Shard& sh : shards) {
+            if (sh.pid < 0) continue;
+            io.emplace_back([&sh] { sh.sent   = write_inputs_bin(sh.inp, sh.lcg, sh.n); });
+            io.emplace_back([&sh] { sh.ok_out = check_outputs_bin(sh.out, sh.chk, sh.count); });
+        }
+        for (Shard& sh : shards) {
+            sh.rc = wait_cmd(sh.pid);
+            unblock_fifo(sh.inp, O_RDONLY);
+            unblock_fifo(sh.out, O_WRONLY);
+        }
+        for (std::thread& t : io) t.join();
+        for (Shard& sh : shards) {
+            std::filesystem::remove(sh.inp, ec);
+            std::filesystem::remove(sh.out, ec);
+        }
+    } else if (COSIM_BLOCKS) {
+        // One tail checker per shard while vsim runs
+        std::vector<std::atomic<bool>> done(shards.size());
+        std::vector<std::thread> io;
+        for (Shard& sh : shards) {
+            if (sh.pid < 0) continue;
+            std::atomic<bool>& d = done[(size_t)(&sh - shards.data())];
+            io.emplace_back([&sh, &d] { sh.ok_out = tail_outputs_blocks(sh.out, sh.chk, sh.count, d); });
+        }
+        for (Shard& sh : shards) {
+            sh.rc = wait_cmd(sh.pid);
+            done[(size_t)(&sh - shards.data())].store(true, std::memory_order_release);
+        }
+        for (std::thread& t : io) t.join();
+    } else {
+        for (Shard& sh : shards) sh.rc = wait_cmd(sh.pid);
+        for_each_shard(shards, [](Shard& sh) {
+            if (sh.rc != 0) return;
+            sh.ok_out = COSIM_TEXT_IO ? check_outputs_txt(sh.out, sh.chk)
+                                      : check_outputs_bin(sh.out, sh.chk, sh.count);
+            if (COSIM_TEXT_IO) sh.count = sh.chk.seen();
+        });
+    }
+
+    // Merge in shard order
+    uint64_t seen = 0, mism = 0;
+    size_t   shown = 0;
+    for (const Shard& sh : shards) {
+        const std::string tag = K > 1 ? " (shard " + std::to_string(&sh - shards.data()) + ")" : "";
+        if (sh.rc != 0) {
+            std::cerr << "[C-TB] vsim failed" << tag;
+            if (COSIM_BLOCKS)
+                std::cerr << " after " << sh.chk.seen() << " of " << sh.n << " sums, "
+                          << sh.chk.mism() << " mismatches so far";
+            std::cerr << "\n";
+            return 3;
+        }
+        if ((COSIM_STREAM || COSIM_DPI) && !sh.sent) {
+            std::cerr << "[C-TB] ERROR: cannot stream inputs to " << sh.inp << "\n";
+            return 2;
+        }
+        if (!sh.ok_out && !COSIM_DPI) {
+            std::cerr << "[C-TB] ERROR: cannot read " << sh.out << "\n";
+            return 4;
+        }
+        if (sh.chk.seen() != sh.n || sh.count != sh.n) {
+            std::cerr << "[C-TB] ERROR: length mismatch outputs=" << sh.chk.seen()
+                      << " inputs=" << sh.n << tag << "\n";
+            return 4;
+        }
+        for (const Checker::Mismatch& m : sh.chk.log()) {
+            if (shown++ == Checker::kKeep) break;
+            std::cerr << "MISMATCH @" << m.index
+                      << " a=" << std::hex << std::uppercase << m.a
+                      << " b=" << m.b
+                      << " out=" << m.got
+                      << " exp=" << m.exp << std::dec << "\n";
         }
+        seen += sh.chk.seen();
+        mism += sh.chk.mism();
     }
 
     if (mism == 0) {
-        std::cout << "[C-TB] PASS: all " << COSIM_N << " matched.\n";
+        std::cout << "[C-TB] PASS: all " << seen << " matched.\n";
         return 0;
     } else {
-        std::cout << "[C-TB] FAIL: " << mism << " mismatches of " << COSIM_N << ".\n";
+        std::cout << "[C-TB] FAIL: " << mism << " mismatches of " << seen << ".\n";
         return 5;
     }
 }
@@ -16,8 +16,9 @@ module dut #(
     input  wire                 out_ready,
     output reg signed [2*DATAW-1:0] out_data
 );
-    // Simple ready/valid: always ready to accept when not in reset
-    assign in_ready = rst_n;
+    // Simple ready/valid: accept when out of reset and the output register is
+    // free or being read this cycle (full rate while out_ready stays high)
+    assign in_ready = rst_n && (!out_valid || out_ready);
 
     // Single-cycle pipeline: capture when in_valid && in_ready
     always @(posedge clk or negedge rst_n) begin
@@ -46,8 +46,30 @@ module tb_top;
     integer sent_cnt, recv_cnt;
     integer sample;
 
-    // Ready policy: always ready to accept DUT output
-    initial out_ready = 1'b1;
+    // Driver: +DRIVE=stream (default, back-to-back) or +DRIVE=item (one sample,
+    // then an idle cycle). Backpressure: +READY_PCT=P keeps out_ready high on
+    // P% of cycles (default 100).
+    string drive     = "stream";
+    integer ready_pct = 100;
+
+    // Ready policy: always ready to accept DUT output, unless +READY_PCT < 100
+    initial begin
+        out_ready = 1'b1;
+        void'($value$plusargs("READY_PCT=%d", ready_pct));
+    end
+    always @(posedge clk) begin
+        if (ready_pct < 100) out_ready <= ($urandom_range(99) < ready_pct);
+    end
+
+    // Next sample from the input file in zero time; skips unparsable lines
+    function automatic bit fetch(output integer v);
+        string skip;
+        while (!$feof(fin)) begin
+            if ($fscanf(fin, "%d\n", v) == 1) return 1;
+            void'($fgets(skip, fin));
+        end
+        return 0;
+    endfunction
 
     // Open files after reset deassertion
     initial begin
@@ -76,6 +98,9 @@ module tb_top;
     end
 
     // Driver: feed one value when DUT is ready
+    //   stream: whenever the held sample is accepted (or none is held), load
+    //           the next one at the same edge, so in_valid never drops
+    //   item:   DR_IDLE/DR_HAVE, one bubble after every sample
     typedef enum int {DR_IDLE, DR_HAVE} dr_state_e;
     dr_state_e dr_st;
 
@@ -84,6 +109,7 @@ module tb_top;
         in_data  = '0;
         dr_st    = DR_IDLE;
         sent_cnt = 0;
+        void'($value$plusargs("DRIVE=%s", drive));
 
         // Wait for files & reset
         @(posedge rst_n);
@@ -91,7 +117,17 @@ module tb_top;
         forever begin
             @(posedge clk);
 
-            case (dr_st)
+            if (drive != "item") begin
+                if (!in_valid || in_ready) begin
+                    if (in_valid) sent_cnt <= sent_cnt + 1;
+                    if (fetch(sample)) begin
+                        in_data  <= sample;
+                        in_valid <= 1'b1;
+                    end else begin
+                        in_valid <= 1'b0;
+                    end
+                end
+            end else case (dr_st)
                 DR_IDLE: begin
                     if (! $feof(fin)) begin
                         // read an integer from the input file
@@ -131,21 +167,33 @@ module tb_top;
         end
     end
 
-    // Finish condition guard
+    // Finish condition guard. The timeout is a stall guard: it fires only when
+    // neither sent nor received has moved for +TIMEOUT_NS=T (default 10 ms), so
+    // it holds for any number of samples.
     initial begin : finish_guard
-        time timeout_ns;
-        time start_time;
-        bit  inputs_done;
+        time    timeout_ns;
+        time    start_time;
+        bit     inputs_done;
+        integer last_sent, last_recv;
 
-        timeout_ns = 10_000_000; // 10 ms safety
+        timeout_ns = 10_000_000; // 10 ms without progress
+        void'($value$plusargs("TIMEOUT_NS=%d", timeout_ns));
         start_time = 0;
 
         @(posedge rst_n);
         start_time = $time;
+        last_sent  = sent_cnt;
+        last_recv  = recv_cnt;
 
         forever begin
             @(posedge clk);
 
+            if (sent_cnt != last_sent || recv_cnt != last_recv) begin
+                last_sent  = sent_cnt;
+                last_recv  = recv_cnt;
+                start_time = $time;
+            end
+
             // check if the input file has been read completely
             inputs_done = $feof(fin) && !in_valid;
 
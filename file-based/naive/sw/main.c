@@ -1,10 +1,42 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <assert.h>
 #include "utils.h"
 
 
+/**
+ * @brief Deterministic test input for sample @p i: a ramp starting at -512,
+ *        wrapped to the DUT's 16-bit signed input range.
+ */
+static int32_t sample_at(size_t i) {
+    return (int16_t)(uint16_t)(i - 512);
+}
+
+/**
+ * @brief Parse "--n=N", "--in=PATH" and "--out=PATH".
+ * @return 0 on success, -1 (after printing usage) on anything else.
+ */
+static int parse_args(int argc, char **argv, size_t *n, const char **in_path, const char **out_path) {
+    for (int i = 1; i < argc; ++i) {
+        const char *a = argv[i];
+        if (strncmp(a, "--n=", 4) == 0) {
+            char *end = NULL;
+            unsigned long long v = strtoull(a + 4, &end, 10);
+            if (a[4] != '\0' && *end == '\0' && v > 0) { *n = (size_t)v; continue; }
+        } else if (strncmp(a, "--in=", 5) == 0 && a[5]) {
+            *in_path = a + 5;
+            continue;
+        } else if (strncmp(a, "--out=", 6) == 0 && a[6]) {
+            *out_path = a + 6;
+            continue;
+        }
+        fprintf(stderr, "usage: %s [--n=N] [--in=PATH] [--out=PATH]   (defaults 1024, %s, %s)\n",
+                argv[0], INPUT_FILE, OUTPUT_FILE);
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Entry point for the C testbench program.
  *
@@ -13,66 +45,95 @@
  * the DUT outputs against a golden reference.
  *
  * Workflow:
- *  1. Allocate and initialize input (`in`), golden reference (`gld`), and output (`out`) buffers.
- *  2. Generate deterministic test inputs, including negative values.
- *  3. Write the input data to an external file (`INPUT_FILE`) for the simulator to consume.
- *  4. Launch the DUT simulator (blocking execution until completion).
- *  5. Read the DUT output data from an external file (`OUTPUT_FILE`).
- *  6. Compare DUT outputs to golden reference values, reporting mismatches (up to 10 printed).
- *  7. Report overall PASS/FAIL status based on comparison results.
- *  8. Free all allocated memory and exit with the appropriate status code.
+ *  1. Parse the sample count and vector paths (`--n=`, `--in=`, `--out=`).
+ *  2. Generate deterministic test inputs, including negative values, CHUNK
+ *     samples at a time, and write them to the input file through a large buffer.
+ *  3. Launch the DUT simulator (blocking execution until completion).
+ *  4. Read the DUT output data back CHUNK samples at a time, regenerate the same
+ *     inputs, run the golden model over the block, and compare.
+ *  5. Report overall PASS/FAIL status based on comparison results.
+ *
+ * Memory is O(CHUNK) whatever N is, so vector files of gigabytes are fine.
  *
  * @note The golden reference model computes y = x² for each input sample.
  *
  * @return
  *  - `0`  if all outputs match the golden reference.
- *  - `1`  if memory allocation fails.
+ *  - `1`  if memory allocation fails or the arguments are invalid.
  *  - `2`  if writing inputs to file fails.
+ *  - `3`  if the simulator cannot be started or fails.
  *  - `4`  if reading outputs from file fails or length mismatches.
  *  - `5`  if any mismatches are detected.
  */
-int main(void) {
-    const size_t N = 1024;
+int main(int argc, char **argv) {
+    size_t      N        = 1024;
+    const char *in_path  = INPUT_FILE;
+    const char *out_path = OUTPUT_FILE;
+    if (parse_args(argc, argv, &N, &in_path, &out_path) != 0) return 1;
 
-    int *in  = (int*)malloc(N * sizeof(int));
-    int *gld = (int*)malloc(N * sizeof(int));
-    int *out = (int*)malloc(N * sizeof(int));
+    int32_t *in  = (int32_t*)malloc(CHUNK * sizeof(int32_t));
+    int32_t *gld = (int32_t*)malloc(CHUNK * sizeof(int32_t));
+    int32_t *out = (int32_t*)malloc(CHUNK * sizeof(int32_t));
 
-    // Allocate buffers
-    if (!in || !gld || !out) { fprintf(stderr, "OOM\n"); return 1; }
+    int      ret = 0;
+    size_t   mism = 0;
 
-    // Create deterministic inputs
-    for (size_t i = 0; i < N; ++i) {
-        in[i]  = (int)(i - 512);       // some negatives too
-        gld[i] = in[i] * in[i];        // golden: y = x*x
-    }
+    // Allocate buffers
+    if (!in || !gld || !out) { fprintf(stderr, "OOM\n"); ret = 1; goto cleanup; }
 
     // 1) Emit input file
-    if (write_inputs((const char *)INPUT_FILE, in, N) != 0) {
-        fprintf(stderr, "ERROR: cannot write %s\n", INPUT_FILE);
-        return 2;
+    io_writer w;
+    if (iow_open(&w, in_path) != 0) {
+        fprintf(stderr, "ERROR: cannot write %s\n", in_path);
+        ret = 2;
+        goto cleanup;
+    }
+    for (size_t base = 0; base < N; base += CHUNK) {
+        const size_t cnt = (N - base < CHUNK) ? N - base : CHUNK;
+        for (size_t i = 0; i < cnt; ++i) in[i] = sample_at(base + i);
+        iow_ints(&w, in, cnt);
+    }
+    if (iow_close(&w) != 0) {
+        fprintf(stderr, "ERROR: cannot write %s\n", in_path);
+        ret = 2;
+        goto cleanup;
     }
 
-    // 2) Launch simulator (blocking)
-    assert(launch_sim() == 0);
+    // 2) Launch simulator (blocking); a stale output file must not pass the check
+    remove(out_path);
+    ret = launch_sim(in_path, out_path);
+    if (ret != 0) goto cleanup;
 
-    // 3) Read DUT outputs
-    if (read_outputs((const char *)OUTPUT_FILE, out, N) != 0) {
-        fprintf(stderr, "ERROR: cannot read %s or length mismatch\n", OUTPUT_FILE);
-        return 4;
+    // 3) Read DUT outputs and 4) compare, one block at a time
+    io_reader r;
+    if (ior_open(&r, out_path) != 0) {
+        fprintf(stderr, "ERROR: cannot read %s or length mismatch\n", out_path);
+        ret = 4;
+        goto cleanup;
     }
-
-    // 4) Compare
-    size_t mism = 0;
-    for (size_t i = 0; i < N; ++i) {
-        if (out[i] != gld[i]) {
-            if (mism < 10) {
-                fprintf(stderr, "MISMATCH @%zu: in=%d  out=%d  gld=%d\n",
-                        i, in[i], out[i], gld[i]);
+    for (size_t base = 0; base < N; base += CHUNK) {
+        const size_t cnt = (N - base < CHUNK) ? N - base : CHUNK;
+        const size_t got = ior_ints(&r, out, cnt);
+        if (got != cnt) {
+            fprintf(stderr, "ERROR: %s: %s after %zu of %zu samples\n", out_path,
+                    r.bad ? "bad value" : "length mismatch", base + got, N);
+            ior_close(&r);
+            ret = 4;
+            goto cleanup;
+        }
+        for (size_t i = 0; i < cnt; ++i) in[i] = sample_at(base + i);
+        golden_square(in, gld, cnt);
+        for (size_t i = 0; i < cnt; ++i) {
+            if (out[i] != gld[i]) {
+                if (mism < 10) {
+                    fprintf(stderr, "MISMATCH @%zu: in=%d  out=%d  gld=%d\n",
+                            base + i, in[i], out[i], gld[i]);
+                }
+                ++mism;
             }
-            ++mism;
         }
     }
+    ior_close(&r);
 
     if (mism == 0) {
         printf("[C-TB] PASS: all %zu samples matched.\n", N);
@@ -80,6 +141,9 @@ int main(void) {
         printf("[C-TB] FAIL: %zu mismatches out of %zu.\n", mism, N);
     }
 
+    ret = (mism == 0) ? 0 : 5;
+
+cleanup:
     free(in); free(gld); free(out);
-    return (mism == 0) ? 0 : 5;
+    return ret;
 }
@@ -1,49 +1,175 @@
 #ifndef __UTILS_H__
 #define __UTILS_H__
 
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #ifdef _WIN32
 #define VSIM_CMD "vsim.exe -c -do sim/run.do"
+#define setenv(name, value, overwrite) _putenv_s(name, value)
 #else
+#include <sys/wait.h>
 #define VSIM_CMD "vsim -c -do sim/run.do"
 #endif
 
 #define INPUT_FILE      "sim/in.dat"
 #define OUTPUT_FILE     "sim/out.dat"
 
+// Samples handled per block (generate -> write, read -> golden -> compare)
+#define CHUNK           65536
+// Bytes per fwrite/fread; the sample files are decimal text, one per line
+#define IO_BUF          (1u << 20)
+// Longest line: "-2147483648\n"
+#define MAX_LINE        12
 
-int write_inputs(const char *path, int *vec, size_t n) {
-    if(!path || !vec || n <= 0) return -1;
-    FILE *f = fopen(path, "w");
-    if (!f) return -1;
+
+// Buffered writer: samples are formatted into IO_BUF bytes, then one fwrite
+typedef struct {
+    FILE   *f;
+    char   *buf;
+    size_t  pos;
+    int     err;
+} io_writer;
+
+int iow_open(io_writer *w, const char *path) {
+    w->pos = 0;
+    w->err = 0;
+    w->buf = (char*)malloc(IO_BUF);
+    w->f   = w->buf ? fopen(path, "wb") : NULL;
+    if (!w->f) { free(w->buf); return -1; }
+    return 0;
+}
+
+static void iow_flush(io_writer *w) {
+    if (w->pos && fwrite(w->buf, 1, w->pos, w->f) != w->pos) w->err = 1;
+    w->pos = 0;
+}
+
+// Decimal, one per line, without printf
+void iow_ints(io_writer *w, const int32_t *vec, size_t n) {
     for (size_t i = 0; i < n; ++i) {
-        fprintf(f, "%d\n", vec[i]); // decimal, one per line
+        if (w->pos + MAX_LINE > IO_BUF) iow_flush(w);
+        char *p = w->buf + w->pos;
+        uint32_t u = vec[i] < 0 ? 0u - (uint32_t)vec[i] : (uint32_t)vec[i];
+        char tmp[10];
+        int  k = 0;
+        do { tmp[k++] = (char)('0' + u % 10); u /= 10; } while (u);
+        if (vec[i] < 0) *p++ = '-';
+        while (k) *p++ = tmp[--k];
+        *p++ = '\n';
+        w->pos = (size_t)(p - w->buf);
     }
-    fclose(f);
+}
+
+// 0 if every byte reached the file
+int iow_close(io_writer *w) {
+    iow_flush(w);
+    if (fclose(w->f) != 0) w->err = 1;
+    free(w->buf);
+    return w->err ? -1 : 0;
+}
+
+
+// Buffered reader: one fread per IO_BUF bytes, integers parsed in place
+typedef struct {
+    FILE   *f;
+    char   *buf;
+    size_t  pos, len;
+    int     eof;
+    int     bad;        // set on a token that is not a 32-bit decimal integer
+} io_reader;
+
+int ior_open(io_reader *r, const char *path) {
+    r->pos = r->len = 0;
+    r->eof = r->bad = 0;
+    r->buf = (char*)malloc(IO_BUF);
+    r->f   = r->buf ? fopen(path, "rb") : NULL;
+    if (!r->f) { free(r->buf); return -1; }
     return 0;
 }
 
-int read_outputs(const char *path, int *vec, size_t n) {
-    if(!path || !vec || n <= 0) return -1;
-    FILE *f = fopen(path, "r");
-    if (!f) return -1;
+// Keep at least MAX_LINE bytes ahead of pos unless the file has ended
+static void ior_fill(io_reader *r) {
+    if (r->eof || r->len - r->pos >= MAX_LINE) return;
+    memmove(r->buf, r->buf + r->pos, r->len - r->pos);
+    r->len -= r->pos;
+    r->pos  = 0;
+    while (!r->eof && r->len < IO_BUF) {
+        const size_t got = fread(r->buf + r->len, 1, IO_BUF - r->len, r->f);
+        r->len += got;
+        if (got == 0) r->eof = 1;
+    }
+}
+
+// Parse up to n integers; returns how many were read (fewer at EOF or on a bad token)
+size_t ior_ints(io_reader *r, int32_t *vec, size_t n) {
     for (size_t i = 0; i < n; ++i) {
-        if (fscanf(f, "%d", &vec[i]) != 1) {
-            fclose(f);
-            return -2; // not enough lines
+        for (;;) {
+            ior_fill(r);
+            if (r->pos == r->len) return i;
+            const char c = r->buf[r->pos];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t') break;
+            ++r->pos;
+        }
+        const int neg = r->buf[r->pos] == '-';
+        size_t p = r->pos + (size_t)neg;
+        int64_t v = 0;
+        int digits = 0;
+        while (p < r->len && r->buf[p] >= '0' && r->buf[p] <= '9' && digits < 11) {
+            v = v * 10 + (r->buf[p++] - '0');
+            ++digits;
         }
+        if (neg) v = -v;
+        if (digits == 0 || digits == 11 || v < INT32_MIN || v > INT32_MAX
+            || (p < r->len && r->buf[p] > ' ')) {
+            r->bad = 1;
+            return i;
+        }
+        vec[i] = (int32_t)v;
+        r->pos = p;
     }
-    fclose(f);
-    return 0;
+    return n;
+}
+
+void ior_close(io_reader *r) {
+    fclose(r->f);
+    free(r->buf);
 }
 
 
-int launch_sim(void) {
+// Golden model y = x*x over a block; no aliasing, so the loop vectorizes
+void golden_square(const int32_t *restrict x, int32_t *restrict y, size_t n) {
+    for (size_t i = 0; i < n; ++i) y[i] = x[i] * x[i];
+}
+
+
+// run.do forwards COSIM_IN / COSIM_OUT to tb_top as +IN= / +OUT=.
+// Returns 0 on success, 3 if the simulator could not be started or failed.
+int launch_sim(const char *in_path, const char *out_path) {
+    if (setenv("COSIM_IN", in_path, 1) != 0 || setenv("COSIM_OUT", out_path, 1) != 0) {
+        fprintf(stderr, "ERROR: cannot pass vector paths to the simulator\n");
+        return 3;
+    }
     printf("[C-TB] Launching simulator: %s\n", VSIM_CMD);
+    fflush(stdout);
     int rc = system(VSIM_CMD);
+    if (rc == -1) {
+        fprintf(stderr, "ERROR: cannot start simulator (%s)\n", VSIM_CMD);
+        return 3;
+    }
+#ifndef _WIN32
+    if (WIFSIGNALED(rc)) {
+        fprintf(stderr, "ERROR: simulator killed by signal %d\n", WTERMSIG(rc));
+        return 3;
+    }
+    if (WIFEXITED(rc)) rc = WEXITSTATUS(rc);
+    if (rc == 127) {
+        fprintf(stderr, "ERROR: simulator not found (is vsim on PATH?)\n");
+        return 3;
+    }
+#endif
     if (rc != 0) {
         fprintf(stderr, "ERROR: simulator returned %d\n", rc);
         return 3;
@@ -51,4 +177,4 @@ int launch_sim(void) {
     return 0;
 }
 
-#endif // __UTILS_H__
\ No newline at end of file
+#endif // __UTILS_H__
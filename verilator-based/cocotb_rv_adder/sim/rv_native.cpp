@@ -0,0 +1,279 @@
+// sim/rv_native.cpp
+// Native drive/scoreboard loop for the cocotb test (see rv_native.py).
+//
+// Built as sim_build/native/librv_native.so (make NATIVE=1) and loaded with
+// ctypes into the running Vtop, where it talks to the model through the same
+// VPI that cocotb uses. Python configures a run and polls for the result;
+// every cycle in between is handled here, in one value-change callback on the
+// falling edge of clk:
+//
+//   - SNAPSHOT  in_ready / out_valid / out_sum. All three are registers in
+//               adder_rv_simple, so on the low phase they already hold what
+//               the upcoming rising edge will see (no ReadOnly() needed).
+//   - DRIVE     in_valid / in_a / in_b / out_ready for that edge.
+//   - POP→ENQ   against the in-order expected queue, exactly as one_cycle()
+//               in test_adder_rv_simple.py does with the pre-edge values.
+//
+// After the random cycles the loop drains (in_valid=0, out_ready=1) until the
+// DUT and the queue are empty, then goes idle and hands the bus back.
+//
+// Build (the Makefile does this when NATIVE=1):
+//   g++ -O2 -fPIC -shared -I$(VERILATOR_ROOT)/include/vltstd -o librv_native.so rv_native.cpp
+#include "vpi_user.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+extern "C" {
+
+struct rvn_stats {
+    uint64_t cycles;       // cycles driven (random + drain)
+    uint64_t drain;        // of which drain cycles
+    uint64_t accepted;     // input transfers
+    uint64_t checked;      // output transfers compared
+    uint64_t errors;       // mismatches + unexpected outputs + leftovers
+    uint64_t pending;      // expected sums still queued when the run ended
+    int      running;
+};
+
+struct rvn_mismatch {
+    uint64_t cycle;
+    uint64_t got, exp;
+    int      unexpected;   // output with an empty queue (exp is meaningless)
+};
+
+}  // extern "C"
+
+namespace {
+
+constexpr unsigned kQueue    = 64;   // power of two; DUT holds 2, Python may seed a few
+constexpr unsigned kMaxRecs  = 16;
+
+struct Native {
+    vpiHandle   clk = nullptr, in_valid = nullptr, in_ready = nullptr, in_a = nullptr, in_b = nullptr;
+    vpiHandle   out_valid = nullptr, out_ready = nullptr, out_sum = nullptr;
+    vpiHandle   cb = nullptr;
+    unsigned    width = 0;
+    uint64_t    mask = 0;
+    std::string error;
+
+    // Run configuration
+    uint64_t cycles = 0, drain_max = 0, rng = 0;
+    unsigned p_valid = 0, p_ready = 0;
+
+    // Run state
+    bool          running = false;
+    uint64_t      q[kQueue];
+    unsigned      q_head = 0, q_size = 0;
+    rvn_stats     st{};
+    rvn_mismatch  recs[kMaxRecs];
+    unsigned      nrecs = 0;
+};
+
+Native g;
+
+inline uint64_t splitmix(uint64_t& s) {
+    uint64_t z = (s += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+inline bool rand_pct(unsigned pct) { return (splitmix(g.rng) % 100) < pct; }
+
+inline uint64_t get_bits(vpiHandle h) {
+    s_vpi_value v;
+    v.format = vpiVectorVal;
+    vpi_get_value(h, &v);
+    uint64_t x = (uint32_t)v.value.vector[0].aval;
+    if (g.width > 32) x |= (uint64_t)(uint32_t)v.value.vector[1].aval << 32;
+    return x & g.mask;
+}
+
+inline int get_bit(vpiHandle h) {
+    s_vpi_value v;
+    v.format = vpiIntVal;
+    vpi_get_value(h, &v);
+    return v.value.integer & 1;
+}
+
+inline void put_bits(vpiHandle h, uint64_t x) {
+    s_vpi_vecval w[2] = {{(PLI_INT32)(uint32_t)x, 0}, {(PLI_INT32)(uint32_t)(x >> 32), 0}};
+    s_vpi_value v;
+    v.format       = vpiVectorVal;
+    v.value.vector = w;
+    vpi_put_value(h, &v, nullptr, vpiNoDelay);
+}
+
+inline void put_bit(vpiHandle h, int b) {
+    s_vpi_value v;
+    v.format        = vpiIntVal;
+    v.value.integer = b;
+    vpi_put_value(h, &v, nullptr, vpiNoDelay);
+}
+
+void record(uint64_t got, uint64_t exp, bool unexpected) {
+    ++g.st.errors;
+    if (g.nrecs < kMaxRecs) g.recs[g.nrecs++] = {g.st.cycles, got, exp, unexpected ? 1 : 0};
+}
+
+// Hand the bus back idle: nothing offered, sink ready
+void finish() {
+    put_bit(g.in_valid, 0);
+    put_bit(g.out_ready, 1);
+    g.st.pending = g.q_size;
+    g.st.errors += g.q_size;
+    g.running = false;
+}
+
+// One cycle, on the falling edge of clk
+void cycle() {
+    const int      out_valid = get_bit(g.out_valid);
+    const int      in_ready  = get_bit(g.in_ready);
+    const bool     drain     = g.st.cycles >= g.cycles;
+
+    if (drain && ((g.q_size == 0 && !out_valid) || g.st.drain >= g.drain_max)) {
+        finish();
+        return;
+    }
+
+    // DRIVE for the upcoming edge
+    int valid = 0, ready = 1;
+    uint64_t a = 0, b = 0;
+    if (!drain) {
+        ready = rand_pct(g.p_ready);
+        valid = rand_pct(g.p_valid);
+        if (valid) {
+            const uint64_t r0 = splitmix(g.rng), r1 = splitmix(g.rng);
+            a = r0 & g.mask;
+            b = r1 & g.mask;
+            put_bits(g.in_a, a);
+            put_bits(g.in_b, b);
+        }
+    }
+    put_bit(g.in_valid, valid);
+    put_bit(g.out_ready, ready);
+
+    // POP first: the output transfer is the oldest expected item
+    if (out_valid && ready) {
+        const uint64_t got = get_bits(g.out_sum);
+        ++g.st.checked;
+        if (g.q_size == 0) {
+            record(got, 0, true);
+        } else {
+            const uint64_t exp = g.q[g.q_head];
+            g.q_head = (g.q_head + 1) & (kQueue - 1);
+            --g.q_size;
+            if (got != exp) record(got, exp, false);
+        }
+    }
+    // ENQ second: input accepted on this edge
+    if (valid && in_ready) {
+        ++g.st.accepted;
+        if (g.q_size < kQueue) g.q[(g.q_head + g.q_size++) & (kQueue - 1)] = (a + b) & g.mask;
+        else                   ++g.st.errors;   // only with a queue over-seeded by rvn_expect()
+    }
+
+    ++g.st.cycles;
+    if (drain) ++g.st.drain;
+}
+
+PLI_INT32 on_clk(p_cb_data cb) {
+    if (g.running && cb->value && cb->value->value.integer == 0) cycle();
+    return 0;
+}
+
+vpiHandle lookup(const char* top, const char* sig) {
+    const std::string name = std::string(top) + "." + sig;
+    vpiHandle h = vpi_handle_by_name((PLI_BYTE8*)name.c_str(), nullptr);
+    if (!h && g.error.empty()) g.error = "no VPI handle for " + name + " (is the model built with --public-flat-rw?)";
+    return h;
+}
+
+}  // namespace
+
+extern "C" {
+
+// Resolve the DUT ports under `top` (cocotb's dut._name) and hook clk.
+// Returns 0, or -1 with the reason in rvn_error().
+int rvn_open(const char* top) {
+    if (g.cb) vpi_remove_cb(g.cb);
+    g = Native{};
+    g.clk       = lookup(top, "clk");
+    g.in_valid  = lookup(top, "in_valid");
+    g.in_ready  = lookup(top, "in_ready");
+    g.in_a      = lookup(top, "in_a");
+    g.in_b      = lookup(top, "in_b");
+    g.out_valid = lookup(top, "out_valid");
+    g.out_ready = lookup(top, "out_ready");
+    g.out_sum   = lookup(top, "out_sum");
+    if (!g.error.empty()) return -1;
+
+    g.width = (unsigned)vpi_get(vpiSize, g.out_sum);
+    if (g.width == 0 || g.width > 64) {
+        g.error = "out_sum is " + std::to_string(g.width) + " bits; the native loop handles 1..64";
+        return -1;
+    }
+    g.mask = g.width == 64 ? ~0ull : ((1ull << g.width) - 1);
+
+    static s_vpi_time  t{vpiSuppressTime, 0, 0, 0};
+    static s_vpi_value v{vpiIntVal, {0}};
+    s_cb_data cb{};
+    cb.reason    = cbValueChange;
+    cb.cb_rtn    = on_clk;
+    cb.obj       = g.clk;
+    cb.time      = &t;
+    cb.value     = &v;
+    g.cb = vpi_register_cb(&cb);
+    if (!g.cb) { g.error = "cannot register a value-change callback on clk"; return -1; }
+    return 0;
+}
+
+const char* rvn_error() { return g.error.c_str(); }
+
+// Carry over an expected sum still in flight from Python's own scoreboard
+int rvn_expect(uint64_t sum) {
+    if (g.running || g.q_size == kQueue) return -1;
+    g.q[(g.q_head + g.q_size++) & (kQueue - 1)] = sum & g.mask;
+    return 0;
+}
+
+// Arm a run: `cycles` random cycles, then at most `drain_max` drain cycles.
+// The loop takes over at the next falling edge of clk; until then the caller
+// should leave in_valid low.
+int rvn_start(uint64_t cycles, uint64_t seed, unsigned p_valid, unsigned p_ready, uint64_t drain_max) {
+    if (!g.cb || g.running) return -1;
+    g.cycles    = cycles;
+    g.drain_max = drain_max;
+    g.rng       = seed;
+    g.p_valid   = p_valid > 100 ? 100 : p_valid;
+    g.p_ready   = p_ready > 100 ? 100 : p_ready;
+    g.st        = rvn_stats{};
+    g.nrecs     = 0;
+    g.running   = true;
+    return 0;
+}
+
+int rvn_done() { return !g.running; }
+
+void rvn_get_stats(rvn_stats* out) {
+    *out = g.st;
+    out->running = g.running;
+    if (g.running) out->pending = g.q_size;
+}
+
+// First mismatches of the last run (up to 16)
+unsigned rvn_mismatches(rvn_mismatch* out, unsigned max) {
+    const unsigned n = g.nrecs < max ? g.nrecs : max;
+    std::memcpy(out, g.recs, n * sizeof(rvn_mismatch));
+    return n;
+}
+
+void rvn_close() {
+    if (g.cb) vpi_remove_cb(g.cb);
+    g = Native{};
+}
+
+}  // extern "C"
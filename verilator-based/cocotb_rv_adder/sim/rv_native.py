@@ -0,0 +1,105 @@
+# sim/rv_native.py
+"""ctypes front end for librv_native.so (sim/rv_native.cpp).
+
+The library is loaded into the running simulator. It drives, samples and
+scores adder_rv_simple in a VPI callback on every falling edge of clk, so
+Python only arms a run and polls for the result:
+
+    nat = RvNative(dut)                  # resolve ports, hook clk
+    nat.start(cycles=1_000_000, seed=1)  # takes over at the next falling edge
+    await nat.wait()                     # few Timer wakeups, no per-cycle GPI
+    stats = nat.stats()
+
+`make NATIVE=1` builds the library and exports its path as RV_NATIVE_LIB.
+"""
+import ctypes
+import os
+
+from cocotb.triggers import Timer
+
+LIB_ENV = "RV_NATIVE_LIB"
+
+
+class Stats(ctypes.Structure):
+    _fields_ = [
+        ("cycles",   ctypes.c_uint64),
+        ("drain",    ctypes.c_uint64),
+        ("accepted", ctypes.c_uint64),
+        ("checked",  ctypes.c_uint64),
+        ("errors",   ctypes.c_uint64),
+        ("pending",  ctypes.c_uint64),
+        ("running",  ctypes.c_int),
+    ]
+
+
+class Mismatch(ctypes.Structure):
+    _fields_ = [
+        ("cycle",      ctypes.c_uint64),
+        ("got",        ctypes.c_uint64),
+        ("exp",        ctypes.c_uint64),
+        ("unexpected", ctypes.c_int),
+    ]
+
+
+def lib_path():
+    """Path of the built library, or None when NATIVE=1 was not used."""
+    path = os.environ.get(LIB_ENV, "")
+    return path if path and os.path.isfile(path) else None
+
+
+def _load(path):
+    lib = ctypes.CDLL(path)
+    lib.rvn_open.argtypes       = [ctypes.c_char_p]
+    lib.rvn_error.restype       = ctypes.c_char_p
+    lib.rvn_expect.argtypes     = [ctypes.c_uint64]
+    lib.rvn_start.argtypes      = [ctypes.c_uint64, ctypes.c_uint64, ctypes.c_uint, ctypes.c_uint, ctypes.c_uint64]
+    lib.rvn_get_stats.argtypes  = [ctypes.POINTER(Stats)]
+    lib.rvn_get_stats.restype   = None
+    lib.rvn_mismatches.argtypes = [ctypes.POINTER(Mismatch), ctypes.c_uint]
+    lib.rvn_mismatches.restype  = ctypes.c_uint
+    lib.rvn_close.restype       = None
+    return lib
+
+
+class RvNative:
+    def __init__(self, dut, path=None):
+        path = path or lib_path()
+        if not path:
+            raise RuntimeError(f"native helper not built (make NATIVE=1 exports {LIB_ENV})")
+        self._lib = _load(path)
+        if self._lib.rvn_open(dut._name.encode()) != 0:
+            raise RuntimeError(self._lib.rvn_error().decode())
+
+    def expect(self, sums):
+        """Seed expected sums still in flight from a Python scoreboard (oldest first)."""
+        for s in sums:
+            if self._lib.rvn_expect(s) != 0:
+                raise RuntimeError("native expected queue is full")
+
+    def start(self, cycles, seed=1, p_valid=70, p_ready=60, drain_max=256):
+        """Arm `cycles` random cycles plus a drain of at most `drain_max` cycles.
+        Call from a driving phase with in_valid low; the loop owns the inputs
+        from the next falling edge until the run is done."""
+        if self._lib.rvn_start(cycles, seed, p_valid, p_ready, drain_max) != 0:
+            raise RuntimeError("native run already active (or not opened)")
+
+    def done(self):
+        return bool(self._lib.rvn_done())
+
+    async def wait(self, period_ns=10, poll_cycles=10_000):
+        """Sleep in poll_cycles-sized steps until the run (and its drain) ends."""
+        while not self.done():
+            await Timer(period_ns * poll_cycles, units="ns")
+
+    def stats(self):
+        st = Stats()
+        self._lib.rvn_get_stats(ctypes.byref(st))
+        return st
+
+    def mismatches(self):
+        recs = (Mismatch * 16)()
+        n = self._lib.rvn_mismatches(recs, 16)
+        return list(recs[:n])
+
+    def close(self):
+        self._lib.rvn_close()
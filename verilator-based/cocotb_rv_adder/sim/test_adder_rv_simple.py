@@ -1,11 +1,15 @@
 # sim/test_adder_rv_simple.py
 import random
+import time
 from collections import deque
 
 import cocotb
 from cocotb.clock import Clock
 from cocotb.triggers import RisingEdge, FallingEdge, ReadOnly
 
+import rv_native
+from vecstore import VecStore   # bench/vecstore.py, on PYTHONPATH via the Makefile
+
 W = 32
 MASK = (1 << W) - 1 if W < 64 else (1 << 64) - 1
 
@@ -168,3 +172,103 @@ async def test_adder_rv_simple(dut):
         errors += 1
 
     assert errors == 0, f"Test FAILED with {errors} mismatches"
+
+@cocotb.test(skip=rv_native.lib_path() is None)
+async def test_adder_rv_native(dut):
+    """Long random run with the per-cycle loop in librv_native.so (make NATIVE=1)."""
+    cycles = int(cocotb.plusargs.get("native_cycles", 1_000_000))
+    seed   = int(cocotb.plusargs.get("native_seed", 1))
+
+    cocotb.start_soon(Clock(dut.clk, 10, units="ns").start())
+    await reset_dut(dut, cycles=4)
+
+    # Short directed prologue in Python; whatever is still in flight is handed over
+    expq = deque()
+    errors = 0
+    for (a, b) in [(MASK, 1), (MASK, MASK)]:
+        await FallingEdge(dut.clk)
+        dut.out_ready.value = 0
+        dut.in_valid.value  = 1
+        dut.in_a.value      = a
+        dut.in_b.value      = b
+        _, e = await one_cycle(dut, expq, pre_label="NAT pre")
+        errors += e
+
+    nat = rv_native.RvNative(dut)
+    await FallingEdge(dut.clk)
+    dut.in_valid.value = 0
+    nat.expect(expq)
+    nat.start(cycles, seed=seed, p_valid=70, p_ready=60)
+
+    t0 = time.perf_counter()
+    await nat.wait(period_ns=10)
+    secs = time.perf_counter() - t0
+
+    st = nat.stats()
+    for m in nat.mismatches():
+        if m.unexpected:
+            dut._log.error("[NAT %d] Unexpected output %d (empty expq)", m.cycle, m.got)
+        else:
+            dut._log.error("[NAT %d] got=%d exp=%d", m.cycle, m.got, m.exp)
+    if st.pending:
+        dut._log.error("Items left in native scoreboard after drain: %d", st.pending)
+    nat.close()
+
+    dut._log.info("native: %d cycles (%d drain), %d accepted, %d checked in %.2f s (%.0f cycles/s)",
+                  st.cycles, st.drain, st.accepted, st.checked, secs,
+                  st.cycles / secs if secs > 0 else 0.0)
+    errors += st.errors
+    assert errors == 0, f"Test FAILED with {errors} mismatches"
+
+@cocotb.test(skip="vectors" not in cocotb.plusargs)
+async def test_adder_rv_vectors(dut):
+    """Replay a shared vector file (+vectors=FILE, ADDV store or ADDB) in order."""
+    st = VecStore(cocotb.plusargs["vectors"])
+    if st.width != W:
+        raise ValueError(f"{cocotb.plusargs['vectors']}: {st.width}-bit operands, DUT is {W}")
+    n = st.count
+    a_col, b_col, sums = st.a, st.b, st.sum
+
+    cocotb.start_soon(Clock(dut.clk, 10, units="ns").start())
+    await reset_dut(dut, cycles=4)
+
+    # The scoreboard predicts from the bus; a stored golden sum is checked
+    # against that prediction as each vector is accepted
+    expq = deque()
+    errors = 0
+    i = 0
+    t = 0
+    t0 = time.perf_counter()
+    while i < n:
+        await FallingEdge(dut.clk)
+        valid = st.valid(t)
+        dut.out_ready.value = int(st.ready(t))
+        dut.in_valid.value  = int(valid)
+        dut.in_a.value      = a_col[i]
+        dut.in_b.value      = b_col[i]
+        accepted, e = await one_cycle(dut, expq, pre_label=f"VEC {i}")
+        errors += e
+        t += 1
+        if accepted:
+            if sums is not None and expq[-1] != sums[i]:
+                dut._log.error("[VEC %d] golden sum %d, a+b=%d", i, sums[i], expq[-1])
+                errors += 1
+            i += 1
+
+    for _ in range(256):
+        await FallingEdge(dut.clk)
+        dut.in_valid.value  = 0
+        dut.out_ready.value = 1
+        _, e = await one_cycle(dut, expq, pre_label="VEC drain")
+        errors += e
+        if not expq and int(dut.out_valid.value) == 0:
+            break
+    secs = time.perf_counter() - t0
+
+    if expq:
+        dut._log.error("Items left in scoreboard after drain: %d", len(expq))
+        errors += 1
+
+    dut._log.info("vectors: %d in %d cycles, %.2f s (%.0f ns/vector)",
+                  n, t, secs, 1e9 * secs / n if n else 0.0)
+    assert errors == 0, f"Test FAILED with {errors} mismatches"
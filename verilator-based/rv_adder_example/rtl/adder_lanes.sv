@@ -0,0 +1,59 @@
+//==============================================================================
+// adder_lanes — M independent adder_rv_simple lanes behind packed ports
+//==============================================================================
+//
+//   in_valid[M-1:0] ──┐   ┌──────────────────┐   ┌── out_valid[M-1:0]
+//   in_a[k], in_b[k] ─┼──▶│ lane k:           │──▶├── out_sum[k]
+//                     │   │ adder_rv_simple   │   │
+//   in_ready[M-1:0] ◀─┘   └──────────────────┘   └── out_ready[M-1:0]
+//                                 × M
+//
+// Notes:
+// * Lane k uses bit k of the valid/ready vectors and element k of the packed
+//   operand/sum arrays; lanes share nothing but clk and rst_n.
+// * With no cross-lane dependencies, Verilator's --threads has M independent
+//   partitions of real work (the single adder has nothing to split).
+// * The harness for this top is sim/tb_lanes.cpp (make run-lanes LANES=M).
+//==============================================================================
+module adder_lanes #(
+  parameter int W = 32,
+  parameter int M = 8
+)(
+  input  logic                clk,
+  input  logic                rst_n,
+
+  // Producers → lanes
+  input  logic [M-1:0]        in_valid,
+  output logic [M-1:0]        in_ready,
+  input  logic [M-1:0][W-1:0] in_a,
+  input  logic [M-1:0][W-1:0] in_b,
+
+  // Lanes → consumers
+  output logic [M-1:0]        out_valid,
+  input  logic [M-1:0]        out_ready,
+  output logic [M-1:0][W-1:0] out_sum
+);
+
+  for (genvar k = 0; k < M; k++) begin : g_lane
+    // Per-lane nets, so each lane's logic only meets the others at the ports
+    logic         lane_in_ready, lane_out_valid;
+    logic [W-1:0] lane_sum;
+
+    adder_rv_simple #(.W(W)) u_adder (
+      .clk        (clk),
+      .rst_n      (rst_n),
+      .in_valid   (in_valid[k]),
+      .in_ready   (lane_in_ready),
+      .in_a       (in_a[k]),
+      .in_b       (in_b[k]),
+      .out_valid  (lane_out_valid),
+      .out_ready  (out_ready[k]),
+      .out_sum    (lane_sum)
+    );
+
+    assign in_ready[k]  = lane_in_ready;
+    assign out_valid[k] = lane_out_valid;
+    assign out_sum[k]   = lane_sum;
+  end
+
+endmodule
@@ -0,0 +1,141 @@
+// sim/adder_word.h
+// Operand/sum word of the W-bit adder, chosen at compile time.
+//
+// Word<W>::type is a plain uint64_t for W <= 64, where the golden add is one
+// native add and a mask. Wider datapaths use WideWord<N>: N 32-bit words,
+// least significant first, which is the layout of Verilator's VlWide<N>
+// (WData[N] before 5.0), so a port is copied in or out with one memcpy.
+// The wide add propagates the carry through a fixed number of words; N is a
+// compile-time constant, so the loop unrolls into straight-line code.
+//
+// Verilator picks the port type from the width (CData/SData/IData/QData up to
+// 64 bits, VlWide above); kPortBytes is its size, which lets the harness
+// check at compile time that it was built for the same W as the model.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+template <std::size_t N>
+struct WideWord {
+    uint32_t w[N];
+
+    bool operator==(const WideWord& o) const { return std::memcmp(w, o.w, sizeof w) == 0; }
+    bool operator!=(const WideWord& o) const { return !(*this == o); }
+};
+
+// Scoreboard value printer (scoreboard.h): hex, most significant word first
+template <std::size_t N>
+inline void sb_print(std::FILE* f, const WideWord<N>& v) {
+    std::fprintf(f, "0x%x", v.w[N - 1]);
+    for (std::size_t k = N - 1; k-- > 0;) std::fprintf(f, "_%08x", v.w[k]);
+}
+
+template <unsigned W>
+struct Word {
+    static_assert(W >= 1, "adder width must be at least 1 bit");
+
+    static constexpr bool        kWide  = W > 64;
+    static constexpr std::size_t kWords = (W + 31) / 32;   // 32-bit words of a wide port
+    static constexpr std::size_t kPortBytes =
+        W <= 8 ? 1 : W <= 16 ? 2 : W <= 32 ? 4 : W <= 64 ? 8 : kWords * 4;
+
+    using type = typename std::conditional<kWide, WideWord<kWords>, uint64_t>::type;
+
+    // Low `bits` bits set (bits <= W)
+    static type mask(unsigned bits) {
+        if constexpr (!kWide) {
+            return bits >= 64 ? ~0ull : ((1ull << bits) - 1);
+        } else {
+            type m{};
+            for (std::size_t k = 0; k < kWords; ++k) {
+                const unsigned lo = (unsigned)k * 32;
+                m.w[k] = bits >= lo + 32 ? ~0u : bits > lo ? ((1u << (bits - lo)) - 1) : 0u;
+            }
+            return m;
+        }
+    }
+    static type ones() { return mask(W); }
+
+    // Only bit `bit` set (bit < W)
+    static type bit(unsigned bit) {
+        if constexpr (!kWide) {
+            return 1ull << bit;
+        } else {
+            type m{};
+            m.w[bit / 32] = 1u << (bit % 32);
+            return m;
+        }
+    }
+
+    static type from_u64(uint64_t v) {
+        if constexpr (!kWide) {
+            return v & ones();
+        } else {
+            type r{};
+            r.w[0] = (uint32_t)v;
+            r.w[1] = (uint32_t)(v >> 32);
+            return r;
+        }
+    }
+
+    // Low 64 bits, for the narrow-only paths (txlog) and messages
+    static uint64_t low64(const type& v) {
+        if constexpr (!kWide) return v;
+        else return (uint64_t)v.w[0] | ((uint64_t)v.w[1] << 32);
+    }
+
+    static bool test(const type& v, unsigned bit) {
+        if constexpr (!kWide) return bit < 64 && ((v >> bit) & 1);
+        else return bit < W && ((v.w[bit / 32] >> (bit % 32)) & 1);
+    }
+
+    // Golden model: (a + b) mod 2^W
+    static type add(const type& a, const type& b) {
+        if constexpr (!kWide) {
+            return (a + b) & ones();
+        } else {
+            type     r;
+            uint64_t c = 0;
+            for (std::size_t k = 0; k < kWords; ++k) {
+                c += (uint64_t)a.w[k] + b.w[k];
+                r.w[k] = (uint32_t)c;
+                c >>= 32;
+            }
+            if constexpr (W % 32 != 0) r.w[kWords - 1] &= (1u << (W % 32)) - 1;
+            return r;
+        }
+    }
+
+    static type and_or(const type& v, const type& and_mask, const type& or_mask) {
+        if constexpr (!kWide) {
+            return (v & and_mask) | or_mask;
+        } else {
+            type r;
+            for (std::size_t k = 0; k < kWords; ++k) r.w[k] = (v.w[k] & and_mask.w[k]) | or_mask.w[k];
+            return r;
+        }
+    }
+
+    // Verilated port <-> word
+    template <class Port>
+    static void put(Port& port, const type& v) {
+        static_assert(sizeof(Port) == kPortBytes, "port width does not match W");
+        if constexpr (!kWide) port = (Port)v;
+        else std::memcpy(&port[0], v.w, sizeof v.w);
+    }
+    template <class Port>
+    static type get(const Port& port) {
+        static_assert(sizeof(Port) == kPortBytes, "port width does not match W");
+        if constexpr (!kWide) {
+            return (uint64_t)port;
+        } else {
+            type r;
+            std::memcpy(r.w, &port[0], sizeof r.w);
+            return r;
+        }
+    }
+};
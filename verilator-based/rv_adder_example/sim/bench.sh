@@ -0,0 +1,72 @@
+#!/bin/sh
+# sim/bench.sh — driven by `make bench`
+# Builds each Verilator configuration into its own obj_bench/<tag>, runs the
+# same workload on it and tabulates build time and simulated cycles/s (taken
+# from the run's logs/perf.json). Knobs are swept one at a time around the
+# Makefile defaults (THREADS=4 TRACE=1 TRACE_THREADS=2 COVERAGE=1).
+set -u
+
+MAKE=${MAKE:-make}
+BIN=${BIN:-sim_adder_rv_simple}
+BENCH_PLUSARGS=${BENCH_PLUSARGS:-+cycles=1000000}
+OUT=logs/bench
+CSV=logs/bench.csv
+
+mkdir -p "$OUT"
+echo "config,threads,trace,trace_threads,coverage,launcher,build_s,cycles_per_s" > "$CSV"
+
+now() { date +%s.%N; }
+
+# bench <tag> <threads> <trace> <trace_threads> <coverage> <launcher: run|numa> [runtime plusargs]
+bench() {
+    tag=$1 thr=$2 trc=$3 tt=$4 cov=$5 how=$6
+    shift 6
+    mdir=obj_bench/$tag
+
+    t0=$(now)
+    if ! $MAKE -s build BUILD="$mdir" THREADS="$thr" TRACE="$trc" \
+              TRACE_THREADS="$tt" COVERAGE="$cov" > "$OUT/$tag.build.log" 2>&1; then
+        echo "$tag,$thr,$trc,$tt,$cov,$how,FAIL,FAIL" >> "$CSV"
+        echo "  $tag: build failed (see $OUT/$tag.build.log)" >&2
+        return
+    fi
+    t1=$(now)
+
+    # Traced builds dump unless the variant says otherwise (first plusarg wins)
+    extra="$*"
+    if [ -z "$extra" ] && [ "$trc" = 1 ]; then extra=+trace=1; fi
+    cmd="./$mdir/$BIN $extra $BENCH_PLUSARGS"
+    if [ "$how" = numa ]; then
+        if ! command -v numactl > /dev/null 2>&1; then
+            echo "  $tag: numactl not found, skipped" >&2
+            return
+        fi
+        cmd="numactl -C 0-$((thr - 1)) -m 0 -- $cmd"
+    fi
+    $cmd > "$OUT/$tag.run.log" 2>&1
+    cp logs/perf.json "$OUT/$tag.json" 2>/dev/null
+
+    # First "cycles_per_s" in the report is the run total
+    cps=$(sed -n 's/.*"cycles_per_s": \([0-9.]*\).*/\1/p' "$OUT/$tag.json" | head -n 1)
+    bs=$(echo "$t1 $t0" | awk '{ printf "%.1f", $1 - $2 }')
+    echo "$tag,$thr,$trc,$tt,$cov,$how,$bs,${cps:-NA}" >> "$CSV"
+}
+
+#     tag             thr trace tt cov launcher
+bench threads1        1   1     2  1   run
+bench threads2        2   1     2  1   run
+bench threads4        4   1     2  1   run
+bench threads8        8   1     2  1   run
+bench trace_off       4   0     0  1   run
+bench trace_on_idle   4   1     2  1   run   +trace=0
+bench trace_threads0  4   1     0  1   run
+bench trace_threads1  4   1     1  1   run
+bench coverage_off    4   1     2  0   run
+bench threads4_numa   4   1     2  1   numa
+
+# Table
+printf '\n%-16s %7s %5s %5s %4s %8s %9s %14s\n' \
+    config threads trace tt cov launcher build_s cycles/s
+awk -F, 'NR > 1 { printf "%-16s %7s %5s %5s %4s %8s %9s %14s\n", $1, $2, $3, $4, $5, $6, $7, $8 }' "$CSV"
+echo
+echo "CSV      : $CSV"
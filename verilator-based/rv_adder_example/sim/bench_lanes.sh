@@ -0,0 +1,49 @@
+#!/bin/sh
+# sim/bench_lanes.sh — driven by `make bench-lanes`
+# Builds adder_lanes for every LANES x THREADS point into its own
+# obj_bench/lanes<M>_t<T>, runs the same random workload on each (tracing off)
+# and tabulates build time, cycles/s and lane-cycles/s (taken from the run's
+# logs/perf_lanes.json). Coverage stays compiled in, as in the default build.
+set -u
+
+MAKE=${MAKE:-make}
+BIN=${BIN:-sim_adder_lanes}
+LANES_SWEEP=${LANES_SWEEP:-1 4 16 64}
+THREADS_SWEEP=${THREADS_SWEEP:-1 2 4 8}
+LANES_PLUSARGS=${LANES_PLUSARGS:-+cycles=200000}
+OUT=logs/bench_lanes
+CSV=logs/bench_lanes.csv
+
+mkdir -p "$OUT"
+echo "config,lanes,threads,build_s,cycles_per_s,lane_cycles_per_s" > "$CSV"
+
+now() { date +%s.%N; }
+
+for m in $LANES_SWEEP; do
+    for thr in $THREADS_SWEEP; do
+        tag=lanes${m}_t${thr}
+        mdir=obj_bench/$tag
+
+        t0=$(now)
+        if ! $MAKE -s lanes LANES_BUILD="$mdir" LANES="$m" THREADS="$thr" TRACE=0 \
+                  > "$OUT/$tag.build.log" 2>&1; then
+            echo "$tag,$m,$thr,FAIL,FAIL,FAIL" >> "$CSV"
+            echo "  $tag: build failed (see $OUT/$tag.build.log)" >&2
+            continue
+        fi
+        t1=$(now)
+
+        ./$mdir/$BIN +perf="$OUT/$tag.json" $LANES_PLUSARGS > "$OUT/$tag.run.log" 2>&1
+
+        cps=$(sed -n 's/.*"cycles_per_s": \([0-9.]*\).*/\1/p' "$OUT/$tag.json" | head -n 1)
+        lps=$(sed -n 's/.*"lane_cycles_per_s": \([0-9.]*\).*/\1/p' "$OUT/$tag.json" | head -n 1)
+        bs=$(echo "$t1 $t0" | awk '{ printf "%.1f", $1 - $2 }')
+        echo "$tag,$m,$thr,$bs,${cps:-NA},${lps:-NA}" >> "$CSV"
+    done
+done
+
+# Table
+printf '\n%-16s %6s %7s %8s %14s %18s\n' config lanes threads build_s cycles/s lane_cycles/s
+awk -F, 'NR > 1 { printf "%-16s %6s %7s %8s %14s %18s\n", $1, $2, $3, $4, $5, $6 }' "$CSV"
+echo
+echo "CSV      : $CSV"
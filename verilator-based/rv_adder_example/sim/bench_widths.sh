@@ -0,0 +1,55 @@
+#!/bin/sh
+# sim/bench_widths.sh — driven by `make bench-widths`
+# Builds adder_rv_simple for every datapath width in WIDTHS (-GW=<W>, harness
+# -DTB_W=<W>) into its own obj_bench/w<W>, runs the same random workload on
+# each (tracing off) and tabulates build time, PASS/FAIL and cycles/s (taken
+# from the run's perf.json). Any failing width makes the script exit 1.
+set -u
+
+MAKE=${MAKE:-make}
+BIN=${BIN:-sim_adder_rv_simple}
+WIDTHS=${WIDTHS:-32 64 128 256 512}
+WIDTH_PLUSARGS=${WIDTH_PLUSARGS:-+cycles=1000000}
+OUT=logs/bench_widths
+CSV=logs/bench_widths.csv
+
+mkdir -p "$OUT"
+echo "config,width,build_s,result,cycles_per_s,accepted_per_s" > "$CSV"
+
+now() { date +%s.%N; }
+rc=0
+
+for w in $WIDTHS; do
+    tag=w$w
+    mdir=obj_bench/$tag
+
+    t0=$(now)
+    if ! $MAKE -s build BUILD="$mdir" W="$w" > "$OUT/$tag.build.log" 2>&1; then
+        echo "$tag,$w,FAIL,FAIL,FAIL,FAIL" >> "$CSV"
+        echo "  $tag: build failed (see $OUT/$tag.build.log)" >&2
+        rc=1
+        continue
+    fi
+    t1=$(now)
+
+    if ./$mdir/$BIN +trace=0 +perf="$OUT/$tag.json" +cov="$OUT/$tag.dat" $WIDTH_PLUSARGS \
+            > "$OUT/$tag.run.log" 2>&1; then
+        res=PASS
+    else
+        res=FAIL
+        rc=1
+        echo "  $tag: run failed (see $OUT/$tag.run.log)" >&2
+    fi
+
+    cps=$(sed -n 's/.*"cycles_per_s": \([0-9.]*\).*/\1/p' "$OUT/$tag.json" | head -n 1)
+    aps=$(sed -n 's/.*"accepted_per_s": \([0-9.]*\).*/\1/p' "$OUT/$tag.json" | head -n 1)
+    bs=$(echo "$t1 $t0" | awk '{ printf "%.1f", $1 - $2 }')
+    echo "$tag,$w,$bs,$res,${cps:-NA},${aps:-NA}" >> "$CSV"
+done
+
+# Table
+printf '\n%-8s %6s %8s %6s %14s %16s\n' config width build_s result cycles/s accepted/s
+awk -F, 'NR > 1 { printf "%-8s %6s %8s %6s %14s %16s\n", $1, $2, $3, $4, $5, $6 }' "$CSV"
+echo
+echo "CSV      : $CSV"
+exit $rc
@@ -0,0 +1,104 @@
+// sim/checkpoint.h
+// Model checkpoints for long soak runs (+checkpoint / +resume in tb_main.cpp).
+//
+// A checkpoint is one trivially copyable blob of harness state (scoreboard
+// ring, generator, cycle counters) followed by the Verilated model's own
+// serialization (VerilatedSave, needs a model built with --savable, make
+// SAVABLE=1). The blob comes first so ckpt_peek() can check a checkpoint
+// against the run's options before any model is built.
+//
+// It is written to PATH.tmp and rename()d over PATH, so a job killed while
+// writing keeps the previous checkpoint, and only the latest checkpoint is
+// ever on disk.
+//
+// The blob carries a magic number and its own size; a checkpoint from a
+// harness with a different layout (other W, other build) is refused instead
+// of restoring garbage. The model part is checked by Verilator itself.
+#pragma once
+
+#include "verilated.h"
+#if TB_SAVABLE
+#include "verilated_save.h"
+#endif
+
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+
+static constexpr uint64_t kCkptMagic = 0x54504b4344444142ull;   // "BADDCKPT"
+
+inline bool ckpt_exists(const std::string& path) { return ::access(path.c_str(), R_OK) == 0; }
+
+#if TB_SAVABLE
+
+template <class Model, class State>
+bool ckpt_save(const std::string& path, Model& top, const State& st) {
+    static_assert(std::is_trivially_copyable<State>::value, "checkpoint state is saved as raw bytes");
+    const std::string tmp = path + ".tmp";
+    const uint64_t hdr[2] = {kCkptMagic, sizeof(State)};
+    {
+        VerilatedSave os;
+        os.open(tmp.c_str());
+        if (!os.isOpen()) return false;
+        os.write(hdr, sizeof hdr);
+        os.write(&st, sizeof st);
+        os << top;
+        os.close();
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+namespace ckpt_detail {
+template <class State>
+bool read_state(VerilatedRestore& os, const std::string& path, State& st, std::string* err) {
+    static_assert(std::is_trivially_copyable<State>::value, "checkpoint state is saved as raw bytes");
+    os.open(path.c_str());
+    if (!os.isOpen()) { *err = "cannot read " + path; return false; }
+    uint64_t hdr[2] = {};
+    os.read(hdr, sizeof hdr);
+    if (hdr[0] != kCkptMagic || hdr[1] != sizeof(State)) {
+        *err = path + " was written by a different harness build";
+        return false;
+    }
+    os.read(&st, sizeof st);
+    return true;
+}
+}  // namespace ckpt_detail
+
+// Harness state only
+template <class State>
+bool ckpt_peek(const std::string& path, State& st, std::string* err) {
+    VerilatedRestore os;
+    return ckpt_detail::read_state(os, path, st, err);
+}
+
+template <class Model, class State>
+bool ckpt_load(const std::string& path, Model& top, State& st, std::string* err) {
+    VerilatedRestore os;
+    if (!ckpt_detail::read_state(os, path, st, err)) return false;
+    os >> top;
+    os.close();
+    return true;
+}
+
+#else  // model built without --savable: no checkpoints
+
+template <class Model, class State>
+bool ckpt_save(const std::string&, Model&, const State&) { return false; }
+
+template <class State>
+bool ckpt_peek(const std::string&, State&, std::string* err) {
+    *err = "model built without --savable (make SAVABLE=1)";
+    return false;
+}
+
+template <class Model, class State>
+bool ckpt_load(const std::string&, Model&, State&, std::string* err) {
+    *err = "model built without --savable (make SAVABLE=1)";
+    return false;
+}
+
+#endif
@@ -0,0 +1,160 @@
+// sim/cov_feedback.h
+// Coverage-directed random stimulus: every K cycles read the model's live
+// coverage counters; as long as new points keep getting hit the traffic stays
+// as it is, and after a window with no progress it moves to the profile that
+// the remaining holes vote for.
+//
+// VerilatedCovContext has no per-point getter, so a snapshot is write() to a
+// scratch file and a parse of its "C '<keys>' <count>" records (a few hundred
+// points for this DUT; negligible next to K cycles of eval()). Each uncovered
+// point is classified by its toggle signal name or, for line/branch points,
+// the text of its source line:
+//   spill + out_buf   refill from the spill slot      -> "refill" (valid 100, ready 50)
+//   spill             second slot filling up          -> "fill"   (valid 95, ready 15)
+//   a '+', sum / operand toggles                      -> "carry"  (operands with the top bit set)
+//   out_ready         output draining with no refill  -> "sparse" (valid 15, ready 95)
+// Without votes the profiles are tried round-robin.
+//
+// Closure is the first snapshot at which every point is covered; the report
+// gives it (and the last cycle that added a point) to window resolution.
+#pragma once
+
+#include "verilated.h"
+#if VM_COVERAGE
+#include "verilated_cov.h"
+#endif
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct CovProfile {
+    const char* name;
+    unsigned    p_valid, p_ready;   // percent; base uses the run's options
+    bool        carry;              // force the top operand bit (carry-out on every add)
+};
+
+class CovFeedback {
+public:
+    enum : unsigned { BASE, FILL, REFILL, CARRY, SPARSE, NPROF };
+
+    CovFeedback(std::string scratch, unsigned p_valid, unsigned p_ready, bool adapt)
+        : m_scratch(std::move(scratch)), m_adapt(adapt) {
+        m_prof[BASE]   = {"base",   p_valid, p_ready, false};
+        m_prof[FILL]   = {"fill",   95, 15, false};
+        m_prof[REFILL] = {"refill", 100, 50, false};
+        m_prof[CARRY]  = {"carry",  p_valid, p_ready, true};
+        m_prof[SPARSE] = {"sparse", 15, 95, false};
+    }
+    ~CovFeedback() { std::remove(m_scratch.c_str()); }
+
+    // Snapshot the counters at `cycle`; returns true if the profile changed
+    template <class Ctx>
+    bool update(Ctx* ctx, uint64_t cycle) {
+        if (!snapshot(ctx)) return false;
+        if (m_covered > m_best) {
+            m_best       = m_covered;
+            m_last_new   = cycle;
+            if (m_covered == m_points && m_closure == kNone) m_closure = cycle;
+            return false;
+        }
+        if (!m_adapt || closed()) return false;
+
+        // No progress in the last window: follow the holes
+        unsigned votes[NPROF] = {};
+        for (const Point& p : m_uncovered) ++votes[classify(p)];
+        unsigned next = NPROF;
+        for (unsigned k = 1; k < NPROF; ++k)
+            if (k != m_cur && votes[k] && (next == NPROF || votes[k] > votes[next])) next = k;
+        if (next == NPROF) next = (m_cur + 1) % NPROF;
+        m_cur = next;
+        return true;
+    }
+
+    const CovProfile& profile() const { return m_prof[m_cur]; }
+    uint64_t points()   const { return m_points; }
+    uint64_t covered()  const { return m_covered; }
+    bool     closed()   const { return m_points && m_covered == m_points; }
+    uint64_t closure()  const { return m_closure; }    // kNone if never closed
+    uint64_t last_new() const { return m_last_new; }
+
+    static constexpr uint64_t kNone = ~0ull;
+
+private:
+    struct Point { std::string file, page, comment; unsigned line; };
+
+    template <class Ctx>
+    bool snapshot(Ctx* ctx) {
+#if VM_COVERAGE
+        ctx->coveragep()->write(m_scratch.c_str());
+#else
+        (void)ctx;
+        return false;
+#endif
+        std::ifstream in(m_scratch);
+        if (!in) return false;
+        m_points = m_covered = 0;
+        m_uncovered.clear();
+        std::string rec;
+        while (std::getline(in, rec)) {
+            // C '<\001key\002value...>' <count>
+            const std::size_t q0 = rec.find('\''), q1 = rec.rfind('\'');
+            if (rec.compare(0, 2, "C ") != 0 || q0 == std::string::npos || q1 <= q0) continue;
+            ++m_points;
+            if (std::strtoull(rec.c_str() + q1 + 1, nullptr, 10) != 0) { ++m_covered; continue; }
+            Point p{};
+            std::size_t i = q0 + 1;
+            while (i < q1) {
+                const std::size_t k = rec.find('\001', i), v = rec.find('\002', k), e = rec.find('\001', v);
+                if (k == std::string::npos || v == std::string::npos || v > q1) break;
+                const std::string key = rec.substr(k + 1, v - k - 1);
+                const std::string val = rec.substr(v + 1, std::min(e, q1) - v - 1);
+                if (key == "f")         p.file = val;
+                else if (key == "l")    p.line = (unsigned)std::strtoul(val.c_str(), nullptr, 10);
+                else if (key == "page") p.page = val;
+                else if (key == "o")    p.comment = val;
+                i = std::min(e, q1);
+            }
+            m_uncovered.push_back(p);
+        }
+        return true;
+    }
+
+    unsigned classify(const Point& p) {
+        const bool toggle = p.page.compare(0, 8, "v_toggle") == 0;
+        const std::string text = toggle ? p.comment : source_line(p.file, p.line);
+        auto has = [&](const char* s) { return text.find(s) != std::string::npos; };
+        if (has("spill") && has("out_buf")) return REFILL;
+        if (has("spill"))                   return FILL;
+        if (toggle && (has("sum") || has("in_a") || has("in_b"))) return CARRY;
+        if (has("+"))                       return CARRY;
+        if (has("out_ready"))               return SPARSE;
+        return BASE;
+    }
+
+    const std::string& source_line(const std::string& file, unsigned line) {
+        static const std::string none;
+        auto it = m_src.find(file);
+        if (it == m_src.end()) {
+            it = m_src.emplace(file, std::vector<std::string>{}).first;
+            std::ifstream in(file);
+            for (std::string l; std::getline(in, l);) it->second.push_back(l);
+        }
+        return (line >= 1 && line <= it->second.size()) ? it->second[line - 1] : none;
+    }
+
+    std::string        m_scratch;
+    bool               m_adapt;
+    CovProfile         m_prof[NPROF];
+    unsigned           m_cur = BASE;
+    uint64_t           m_points = 0, m_covered = 0, m_best = 0;
+    uint64_t           m_closure = kNone, m_last_new = 0;
+    std::vector<Point> m_uncovered;
+    std::map<std::string, std::vector<std::string>> m_src;
+};
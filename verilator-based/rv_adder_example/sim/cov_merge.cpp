@@ -0,0 +1,72 @@
+// sim/cov_merge.cpp
+// Standalone parallel merge of Verilator coverage shards (see cov_merge.h),
+// for shards written by separate processes or machines. `+seeds` runs of the
+// harness already merge their own shards in-process.
+//
+//   cov_merge [-j N] -o OUT  FILE|DIR...
+//
+// A DIR argument stands for every *.dat file directly inside it (OUT itself
+// excluded). The result feeds `verilator_coverage --annotate` like any
+// single-run coverage.dat.
+//
+// Build (the Makefile target cov-merge does this):
+//   g++ -O2 -std=c++17 -pthread -o cov_merge cov_merge.cpp
+#include "cov_merge.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
+#include <vector>
+
+static int usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [-j N] -o OUT FILE|DIR...   (-j 0 = one thread per CPU)\n", prog);
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    namespace fs = std::filesystem;
+    std::string out;
+    unsigned jobs = 0;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        if (!std::strcmp(argv[i], "-o") && i + 1 < argc)      out = argv[++i];
+        else if (!std::strcmp(argv[i], "-j") && i + 1 < argc) jobs = (unsigned)std::strtoul(argv[++i], nullptr, 10);
+        else if (argv[i][0] == '-')                           return usage(argv[0]);
+        else                                                  args.push_back(argv[i]);
+    }
+    if (out.empty() || args.empty()) return usage(argv[0]);
+
+    std::error_code ec;
+    const fs::path out_abs = fs::absolute(out, ec);
+    std::vector<std::string> inputs;
+    for (const std::string& a : args) {
+        if (!fs::is_directory(a, ec)) { inputs.push_back(a); continue; }
+        std::vector<std::string> dir;
+        for (const fs::directory_entry& e : fs::directory_iterator(a, ec))
+            if (e.is_regular_file(ec) && e.path().extension() == ".dat"
+                && fs::absolute(e.path(), ec) != out_abs)
+                dir.push_back(e.path().string());
+        std::sort(dir.begin(), dir.end());
+        inputs.insert(inputs.end(), dir.begin(), dir.end());
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::string> failed;
+    CovDb db;
+    const bool ok = cov_merge_files(inputs, out, jobs, &failed, &db);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    for (const std::string& f : failed) std::fprintf(stderr, "cov_merge: cannot read %s\n", f.c_str());
+    if (!ok) {
+        std::fprintf(stderr, "cov_merge: nothing merged into %s\n", out.c_str());
+        return 1;
+    }
+    std::printf("cov_merge: %llu files, %zu points (%zu covered) -> %s in %.3f s\n",
+                (unsigned long long)db.files(), db.points(), db.covered(), out.c_str(), secs);
+    return failed.empty() ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+// sim/cov_merge.h
+// Fast merge of Verilator coverage files (logs/coverage_s<seed>.dat shards)
+// into one database for verilator_coverage --annotate.
+//
+// A .dat file is a "# SystemC::Coverage-3" header plus one
+//   C '<\001key\002value...>' <count>
+// record per point; merging sums the counts of identical key strings. Files
+// are split into one contiguous slice per worker thread, each worker sums its
+// slice into a private table, and the tables are then folded in a pairwise
+// tree. Shards of one model list their points in the same order, so a record
+// is first compared with the key at the same position of the table and only
+// hashed when that misses. No Verilator runtime is needed (sim/cov_merge.cpp
+// is the standalone tool).
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CovDb {
+public:
+    // Add every record of one file; false if it cannot be read
+    bool add_file(const std::string& path) {
+        std::FILE* f = std::fopen(path.c_str(), "rb");
+        if (!f) return false;
+        m_buf.clear();
+        char chunk[1 << 16];
+        for (std::size_t n; (n = std::fread(chunk, 1, sizeof chunk, f)) > 0;) m_buf.append(chunk, n);
+        std::fclose(f);
+
+        std::size_t pos = 0, idx = 0;
+        while (pos < m_buf.size()) {
+            std::size_t eol = m_buf.find('\n', pos);
+            if (eol == std::string::npos) eol = m_buf.size();
+            // C '<keys>' <count>
+            if (eol - pos > 4 && m_buf.compare(pos, 3, "C '") == 0) {
+                const std::size_t q = m_buf.rfind('\'', eol - 1);
+                if (q != std::string::npos && q > pos + 2) {
+                    const char* k = m_buf.data() + pos + 3;
+                    const std::size_t klen = q - (pos + 3);
+                    add(k, klen, std::strtoull(m_buf.data() + q + 1, nullptr, 10), idx++);
+                }
+            }
+            pos = eol + 1;
+        }
+        ++m_files;
+        return true;
+    }
+
+    // Fold another table into this one
+    void merge(const CovDb& o) {
+        for (std::size_t i = 0; i < o.m_keys.size(); ++i)
+            add(o.m_keys[i].data(), o.m_keys[i].size(), o.m_counts[i], i);
+        m_files += o.m_files;
+    }
+
+    bool write(const std::string& path) const {
+        std::FILE* f = std::fopen(path.c_str(), "wb");
+        if (!f) return false;
+        std::fputs("# SystemC::Coverage-3\n", f);
+        for (std::size_t i = 0; i < m_keys.size(); ++i)
+            std::fprintf(f, "C '%s' %llu\n", m_keys[i].c_str(), (unsigned long long)m_counts[i]);
+        return std::fclose(f) == 0;
+    }
+
+    std::size_t points()  const { return m_keys.size(); }
+    uint64_t    files()   const { return m_files; }
+    std::size_t covered() const {
+        return (std::size_t)std::count_if(m_counts.begin(), m_counts.end(), [](uint64_t c) { return c != 0; });
+    }
+
+private:
+    void add(const char* k, std::size_t len, uint64_t count, std::size_t hint) {
+        // Same model, same point order: the key at this position usually matches
+        if (hint < m_keys.size() && m_keys[hint].size() == len && m_keys[hint].compare(0, len, k, len) == 0) {
+            m_counts[hint] += count;
+            return;
+        }
+        std::string key(k, len);
+        auto it = m_index.find(key);
+        if (it != m_index.end()) { m_counts[it->second] += count; return; }
+        m_index.emplace(key, m_keys.size());
+        m_keys.push_back(std::move(key));
+        m_counts.push_back(count);
+    }
+
+    std::vector<std::string>                     m_keys;     // first-seen order
+    std::vector<uint64_t>                        m_counts;
+    std::unordered_map<std::string, std::size_t> m_index;
+    std::string                                  m_buf;      // file being parsed
+    uint64_t                                     m_files = 0;
+};
+
+// Merge `inputs` into `out` with up to `jobs` threads (0 = hardware threads).
+// Unreadable inputs are listed in `failed`; returns false if nothing could be
+// read or the output cannot be written.
+inline bool cov_merge_files(const std::vector<std::string>& inputs, const std::string& out,
+                            unsigned jobs, std::vector<std::string>* failed = nullptr,
+                            CovDb* result = nullptr) {
+    if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+    jobs = (unsigned)std::max<std::size_t>(1, std::min<std::size_t>(jobs, inputs.size()));
+
+    std::vector<CovDb> part(jobs);
+    std::vector<std::vector<std::string>> bad(jobs);
+    std::vector<std::thread> pool;
+    for (unsigned w = 0; w < jobs; ++w) {
+        pool.emplace_back([&, w] {
+            const std::size_t lo = inputs.size() * w / jobs, hi = inputs.size() * (w + 1) / jobs;
+            for (std::size_t i = lo; i < hi; ++i)
+                if (!part[w].add_file(inputs[i])) bad[w].push_back(inputs[i]);
+        });
+    }
+    for (auto& t : pool) t.join();
+
+    // Pairwise tree: log2(jobs) rounds, each round's folds in parallel
+    for (unsigned step = 1; step < jobs; step *= 2) {
+        pool.clear();
+        for (unsigned w = 0; w + step < jobs; w += 2 * step)
+            pool.emplace_back([&, w, step] { part[w].merge(part[w + step]); part[w + step] = CovDb{}; });
+        for (auto& t : pool) t.join();
+    }
+
+    if (failed)
+        for (auto& b : bad) failed->insert(failed->end(), b.begin(), b.end());
+    if (part[0].files() == 0) return false;
+    if (result) *result = part[0];
+    return part[0].write(out);
+}
@@ -0,0 +1,225 @@
+// sim/dut_stats.h
+// Performance analytics of the DUT itself, as opposed to the testbench:
+// how the 2-entry elastic buffer behaves under the offered load.
+//
+//   cycle(now, ...)   every evaluated cycle, with the pre-edge handshakes
+//   idle(n, ready)    a fast-forwarded idle span (nothing offered, DUT empty)
+//   finish()          end of the measured phase (closes an open stall run)
+//
+// Everything lives in fixed arrays (no allocation, trivially copyable, so a
+// forked child can send it through its result pipe):
+//   - accept-to-emit latency per transaction, from a small in-order ring of
+//     accept cycles mirroring the scoreboard
+//   - lengths of in_ready-low runs (the source is back-pressured)
+//   - occupancy (out_buf_valid + spill_buf_valid, i.e. out_valid + !in_ready)
+//     per cycle, and as a timeline of kSlots windows whose span doubles
+//     whenever the slots run out, so any run length fits
+//   - offered valid/ready against accepted/emitted transfers
+#pragma once
+
+#include "verilated.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Fixed-bucket histogram: values 0..N-2 exactly, bucket N-1 holds the rest
+template <std::size_t N>
+struct Histogram {
+    uint64_t bucket[N] = {};
+    uint64_t count = 0, sum = 0, max = 0;
+
+    inline void add(uint64_t v) {
+        ++bucket[v < N - 1 ? v : N - 1];
+        ++count;
+        sum += v;
+        if (v > max) max = v;
+    }
+
+    void merge(const Histogram& o) {
+        for (std::size_t i = 0; i < N; ++i) bucket[i] += o.bucket[i];
+        count += o.count;
+        sum   += o.sum;
+        if (o.max > max) max = o.max;
+    }
+
+    double mean() const { return count ? (double)sum / count : 0.0; }
+
+    // Smallest bucket value covering fraction p of the samples (N-1 = "N-1 or more")
+    uint64_t percentile(double p) const {
+        if (!count) return 0;
+        const double want = p * count;
+        uint64_t acc = 0;
+        for (std::size_t i = 0; i < N; ++i) {
+            acc += bucket[i];
+            if (acc >= want && acc) return i;
+        }
+        return N - 1;
+    }
+
+    // {"count", "mean", "p50", "p90", "p99", "max", "buckets": [0..last non-empty]}
+    void json(std::FILE* f) const {
+        std::fprintf(f, "{\"count\": %llu, \"mean\": %.3f, \"p50\": %llu, \"p90\": %llu, \"p99\": %llu, "
+                        "\"max\": %llu, \"buckets\": [",
+                     (unsigned long long)count, mean(), (unsigned long long)percentile(0.50),
+                     (unsigned long long)percentile(0.90), (unsigned long long)percentile(0.99),
+                     (unsigned long long)max);
+        std::size_t last = N;
+        while (last > 0 && !bucket[last - 1]) --last;
+        for (std::size_t i = 0; i < last; ++i)
+            std::fprintf(f, "%s%llu", i ? ", " : "", (unsigned long long)bucket[i]);
+        std::fprintf(f, "]}");
+    }
+};
+
+struct DutStats {
+    static constexpr std::size_t kLatBuckets   = 64;    // latency 0..62 cycles, 63 = more
+    static constexpr std::size_t kStallBuckets = 64;    // run length 0..62 cycles, 63 = more
+    static constexpr std::size_t kSlots        = 128;   // occupancy timeline resolution
+    static constexpr std::size_t kRing         = 8;     // accept cycles in flight (DUT holds 2)
+    static constexpr uint64_t    kFirstSpan    = 64;    // cycles per timeline slot to start with
+
+    // Totals over the measured cycles
+    uint64_t cycles    = 0;
+    uint64_t valid     = 0;     // in_valid high (offered)
+    uint64_t ready     = 0;     // out_ready high (sink willing)
+    uint64_t accepted  = 0;
+    uint64_t emitted   = 0;
+    uint64_t stall     = 0;     // in_ready low
+    uint64_t blocked   = 0;     // in_valid high while in_ready low
+    uint64_t starved   = 0;     // out_ready high with nothing to send
+    uint64_t occ[3]    = {};    // cycles holding 0 / 1 / 2 items
+
+    Histogram<kLatBuckets>   latency;     // accept edge -> emit edge, in cycles
+    Histogram<kStallBuckets> stall_runs;  // consecutive in_ready-low cycles
+
+    // Occupancy timeline: slot i sums occupancy over cycles [i*span, (i+1)*span)
+    uint64_t tl_sum[kSlots] = {};
+    uint64_t tl_span = kFirstSpan, tl_used = 0, tl_fill = 0;
+
+    inline void cycle(uint64_t now, bool in_valid, bool in_ready, bool out_valid, bool out_ready) {
+        const unsigned held = (unsigned)out_valid + (unsigned)!in_ready;
+        ++cycles;
+        valid   += in_valid;
+        ready   += out_ready;
+        blocked += in_valid && !in_ready;
+        starved += out_ready && !out_valid;
+        ++occ[held];
+
+        if (!in_ready) {
+            ++stall;
+            ++m_run;
+        } else if (m_run) {
+            stall_runs.add(m_run);
+            m_run = 0;
+        }
+
+        // Emit first: the transfer at this edge is the oldest accepted item
+        if (out_valid && out_ready) {
+            ++emitted;
+            if (m_head != m_tail) latency.add(now - m_ring[m_head++ % kRing]);
+        }
+        if (in_valid && in_ready) {
+            ++accepted;
+            if (m_tail - m_head < kRing) m_ring[m_tail++ % kRing] = now;
+        }
+        tl_sum[tl_used] += held;
+        if (VL_UNLIKELY(++tl_fill == tl_span)) next_slot();
+    }
+
+    // n fast-forwarded cycles: DUT empty, nothing offered, `ready_cycles` with out_ready
+    void idle(uint64_t n, uint64_t ready_cycles) {
+        if (m_run) { stall_runs.add(m_run); m_run = 0; }
+        cycles  += n;
+        ready   += ready_cycles;
+        starved += ready_cycles;
+        occ[0]  += n;
+        timeline(0, n);
+    }
+
+    void finish() {
+        if (m_run) { stall_runs.add(m_run); m_run = 0; }
+    }
+
+    // Totals of several runs; the timeline stays per run
+    void merge(const DutStats& o) {
+        cycles += o.cycles; valid += o.valid; ready += o.ready;
+        accepted += o.accepted; emitted += o.emitted;
+        stall += o.stall; blocked += o.blocked; starved += o.starved;
+        for (unsigned i = 0; i < 3; ++i) occ[i] += o.occ[i];
+        latency.merge(o.latency);
+        stall_runs.merge(o.stall_runs);
+    }
+
+    double rate(uint64_t n) const { return cycles ? (double)n / cycles : 0.0; }
+    double mean_occupancy() const { return rate(occ[1] + 2 * occ[2]); }
+
+    // Emitted per cycle against what the offered load allows: min(valid, ready)
+    double efficiency() const {
+        const uint64_t bound = valid < ready ? valid : ready;
+        return bound ? (double)emitted / bound : 0.0;
+    }
+
+    // JSON object; p_valid/p_ready are the configured targets (percent)
+    void json(std::FILE* f, unsigned p_valid, unsigned p_ready, bool with_timeline) const {
+        std::fprintf(f, "{\"cycles\": %llu, \"offered\": {\"p_valid\": %u, \"p_ready\": %u, "
+                        "\"valid\": %.4f, \"ready\": %.4f}, "
+                        "\"accepted_per_cycle\": %.4f, \"emitted_per_cycle\": %.4f, \"efficiency\": %.4f, "
+                        "\"in_ready_low\": %.4f, \"blocked\": %.4f, \"starved\": %.4f, "
+                        "\"occupancy\": {\"mean\": %.4f, \"cycles\": [%llu, %llu, %llu]}, \"latency\": ",
+                     (unsigned long long)cycles, p_valid, p_ready, rate(valid), rate(ready),
+                     rate(accepted), rate(emitted), efficiency(),
+                     rate(stall), rate(blocked), rate(starved), mean_occupancy(),
+                     (unsigned long long)occ[0], (unsigned long long)occ[1], (unsigned long long)occ[2]);
+        latency.json(f);
+        std::fprintf(f, ", \"stall_runs\": ");
+        stall_runs.json(f);
+        if (with_timeline) {
+            std::fprintf(f, ", \"occupancy_timeline\": {\"span\": %llu, \"mean\": [",
+                         (unsigned long long)tl_span);
+            const std::size_t n = tl_used + (tl_fill ? 1 : 0);
+            for (std::size_t i = 0; i < n; ++i) {
+                const uint64_t len = i < tl_used ? tl_span : tl_fill;
+                std::fprintf(f, "%s%.3f", i ? ", " : "", (double)tl_sum[i] / len);
+            }
+            std::fprintf(f, "]}");
+        }
+        std::fprintf(f, "}");
+    }
+
+    // One console line
+    void print(std::FILE* f) const {
+        std::fprintf(f, "offered valid %.1f%% ready %.1f%%, emitted %.3f/cycle (%.1f%% of min), "
+                        "latency mean %.2f p99 %llu max %llu, in_ready low %.1f%% (p99 run %llu), "
+                        "occupancy %.2f",
+                     100 * rate(valid), 100 * rate(ready), rate(emitted), 100 * efficiency(),
+                     latency.mean(), (unsigned long long)latency.percentile(0.99),
+                     (unsigned long long)latency.max, 100 * rate(stall),
+                     (unsigned long long)stall_runs.percentile(0.99), mean_occupancy());
+    }
+
+private:
+    void timeline(unsigned held, uint64_t n) {
+        while (n) {
+            const uint64_t take = n < tl_span - tl_fill ? n : tl_span - tl_fill;
+            tl_sum[tl_used] += held * take;
+            tl_fill += take;
+            n -= take;
+            if (tl_fill == tl_span) next_slot();
+        }
+    }
+
+    void next_slot() {
+        tl_fill = 0;
+        if (++tl_used < kSlots) return;
+        // Out of slots: halve the resolution
+        for (std::size_t i = 0; i < kSlots / 2; ++i) tl_sum[i] = tl_sum[2 * i] + tl_sum[2 * i + 1];
+        for (std::size_t i = kSlots / 2; i < kSlots; ++i) tl_sum[i] = 0;
+        tl_used = kSlots / 2;
+        tl_span *= 2;
+    }
+
+    uint64_t m_ring[kRing] = {};
+    uint64_t m_head = 0, m_tail = 0;
+    uint64_t m_run  = 0;
+};
@@ -0,0 +1,149 @@
+// sim/flight_recorder.h
+// Pre-trigger "flight recorder": the last K cycles of port-level state kept in a
+// fixed ring (allocated once), written out as FST only when a run fails.
+//
+// Each record is the pre-edge state of one clock cycle (sampled after the
+// low-phase eval, i.e. exactly what the DUT sees at the next rising edge).
+// The internal buffer flags follow from the ports: out_valid is out_buf_valid
+// and in_ready is !spill_buf_valid (see rtl/adder_rv_simple.sv). Operands
+// and sums are stored as Word<W> values (adder_word.h), so wide ports are
+// recorded in full.
+#pragma once
+
+#include "adder_word.h"
+#include "verilated.h"
+#if VM_TRACE_FST
+#include "gtkwave/fstapi.h"     // FST writer shipped with Verilator (linked via --trace-fst)
+#endif
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+template <unsigned W>
+class FlightRecorder {
+public:
+    using AW = Word<W>;
+    using Op = typename AW::type;
+
+    struct Rec {
+        uint64_t time;          // half-cycle time of the low phase
+        Op       a, b, sum;
+        uint8_t  flags;         // F_* bits below
+    };
+    enum : uint8_t {
+        F_RST_N     = 1u << 0,
+        F_IN_VALID  = 1u << 1,
+        F_IN_READY  = 1u << 2,
+        F_OUT_VALID = 1u << 3,
+        F_OUT_READY = 1u << 4,
+    };
+
+    // depth is rounded up to a power of two; post = cycles still recorded
+    // after the trigger before the ring freezes
+    FlightRecorder(uint64_t depth, uint64_t post) : m_post(post) {
+        uint64_t cap = 1;
+        while (cap < depth) cap <<= 1;
+        m_ring.resize(cap);
+        m_mask = cap - 1;
+    }
+
+    template <class Model>
+    inline void sample(const Model* top, vluint64_t time) {
+        if (VL_UNLIKELY(m_frozen)) return;
+        Rec& r  = m_ring[m_head & m_mask];
+        r.time  = time;
+        r.a     = AW::get(top->in_a);
+        r.b     = AW::get(top->in_b);
+        r.sum   = AW::get(top->out_sum);
+        r.flags = (uint8_t)((top->rst_n     ? F_RST_N     : 0)
+                          | (top->in_valid  ? F_IN_VALID  : 0)
+                          | (top->in_ready  ? F_IN_READY  : 0)
+                          | (top->out_valid ? F_OUT_VALID : 0)
+                          | (top->out_ready ? F_OUT_READY : 0));
+        ++m_head;
+        if (VL_UNLIKELY(m_triggered) && m_post_left-- == 0) m_frozen = true;
+    }
+
+    // First mismatch: keep `post` more cycles, then stop overwriting
+    void trigger() {
+        if (m_triggered) return;
+        m_triggered = true;
+        m_post_left = m_post;
+    }
+
+    uint64_t size() const { return m_head < m_ring.size() ? m_head : m_ring.size(); }
+
+    // Dump the ring (oldest first) as an FST with the DUT's port names.
+    // Needs the FST writer, i.e. a model built with --trace-fst.
+    bool write_fst(const std::string& path) const {
+#if VM_TRACE_FST
+        const unsigned width = W;
+        void* fst = fstWriterCreate(path.c_str(), /*use_compressed_hier*/ 1);
+        if (!fst) return false;
+        fstWriterSetTimescale(fst, -12);
+        fstWriterSetScope(fst, FST_ST_VCD_MODULE, "TOP", nullptr);
+        fstWriterSetScope(fst, FST_ST_VCD_MODULE, "adder_rv_simple", nullptr);
+        const fstHandle h_clk   = var(fst, "clk", 1);
+        const fstHandle h_rst   = var(fst, "rst_n", 1);
+        const fstHandle h_iv    = var(fst, "in_valid", 1);
+        const fstHandle h_ir    = var(fst, "in_ready", 1);
+        const fstHandle h_a     = var(fst, "in_a", width);
+        const fstHandle h_b     = var(fst, "in_b", width);
+        const fstHandle h_ov    = var(fst, "out_valid", 1);
+        const fstHandle h_or    = var(fst, "out_ready", 1);
+        const fstHandle h_sum   = var(fst, "out_sum", width);
+        const fstHandle h_obv   = var(fst, "out_buf_valid", 1);
+        const fstHandle h_spv   = var(fst, "spill_buf_valid", 1);
+        fstWriterSetUpscope(fst);
+        fstWriterSetUpscope(fst);
+
+        std::string bits(width, '0');
+        auto emit_bit = [&](fstHandle h, bool v) { fstWriterEmitValueChange(fst, h, v ? "1" : "0"); };
+        auto emit_vec = [&](fstHandle h, const Op& v) {
+            for (unsigned i = 0; i < width; ++i)
+                bits[width - 1 - i] = AW::test(v, i) ? '1' : '0';
+            fstWriterEmitValueChange(fst, h, bits.c_str());
+        };
+
+        const uint64_t n = size();
+        for (uint64_t i = m_head - n; i < m_head; ++i) {
+            const Rec& r = m_ring[i & m_mask];
+            fstWriterEmitTimeChange(fst, r.time);
+            emit_bit(h_clk, false);
+            emit_bit(h_rst, r.flags & F_RST_N);
+            emit_bit(h_iv,  r.flags & F_IN_VALID);
+            emit_bit(h_ir,  r.flags & F_IN_READY);
+            emit_vec(h_a,   r.a);
+            emit_vec(h_b,   r.b);
+            emit_bit(h_ov,  r.flags & F_OUT_VALID);
+            emit_bit(h_or,  r.flags & F_OUT_READY);
+            emit_vec(h_sum, r.sum);
+            emit_bit(h_obv, r.flags & F_OUT_VALID);
+            emit_bit(h_spv, !(r.flags & F_IN_READY));
+            fstWriterEmitTimeChange(fst, r.time + 1);
+            emit_bit(h_clk, true);
+        }
+        fstWriterClose(fst);
+        return true;
+#else
+        (void)path;
+        return false;
+#endif
+    }
+
+private:
+#if VM_TRACE_FST
+    static fstHandle var(void* fst, const char* name, unsigned width) {
+        return fstWriterCreateVar(fst, FST_VT_VCD_WIRE, FST_VD_IMPLICIT, width, name, 0);
+    }
+#endif
+
+    std::vector<Rec> m_ring;
+    uint64_t m_mask      = 0;
+    uint64_t m_head      = 0;   // total records written
+    uint64_t m_post      = 0;
+    uint64_t m_post_left = 0;
+    bool     m_triggered = false;
+    bool     m_frozen    = false;
+};
@@ -0,0 +1,97 @@
+// sim/lane_stimulus.h
+// Block-wise random stimulus + golden sums for M lanes at once (tb_lanes.cpp).
+//
+// Same scheme as StimulusBlock (stimulus.h): counter-based SplitMix64 draws,
+// so a lane's traffic depends only on (seed, lane, cycle). Records are stored
+// cycle-major, lanes contiguous ([cycle * M + lane]), which is both the order
+// the packed DUT ports want and a flat loop the compiler vectorizes in
+// SIMD-width groups of lanes. One 64-bit draw gives both 32-bit operands.
+// Valid/ready are packed into one mask per cycle (bit k = lane k).
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+template <unsigned M>
+class LaneStimulus {
+    static_assert(M >= 1 && M <= 64, "lane masks are one 64-bit word per cycle");
+public:
+    static constexpr std::size_t kBlock = 1024;            // cycles per fill()
+
+    LaneStimulus(uint64_t seed, unsigned p_valid_pct, unsigned p_ready_pct) {
+        for (unsigned s = 0; s < 3; ++s) m_key[s] = mix64(seed * 3 + s + 0x3C6EF372FE94F82Aull);
+        m_thr_valid = threshold(p_valid_pct);
+        m_thr_ready = threshold(p_ready_pct);
+    }
+
+    // Generate the next kBlock cycles for every lane
+    void fill() {
+        const uint64_t base = m_ctr * M;
+        m_ctr += kBlock;
+
+        uint32_t* __restrict a   = m_a;
+        uint32_t* __restrict b   = m_b;
+        uint32_t* __restrict sum = m_sum;
+        uint8_t*  __restrict pv  = m_tmp_v;
+        uint8_t*  __restrict pr  = m_tmp_r;
+        const uint64_t kab = m_key[0], kv = m_key[1], kr = m_key[2];
+        const uint64_t tv = m_thr_valid, tr = m_thr_ready;
+
+        // All lanes of all cycles in one independent-lane pass
+        for (std::size_t j = 0; j < kBlock * M; ++j) {
+            const uint64_t c  = (base + j) * kGamma;
+            const uint64_t ab = mix64(kab + c);
+            a[j]  = (uint32_t)ab;
+            b[j]  = (uint32_t)(ab >> 32);
+            pv[j] = (uint8_t)((mix64(kv + c) >> 32) < tv);
+            pr[j] = (uint8_t)((mix64(kr + c) >> 32) < tr);
+        }
+
+        // Golden model for the whole block
+        for (std::size_t j = 0; j < kBlock * M; ++j) sum[j] = a[j] + b[j];
+
+        // One valid / ready mask per cycle
+        for (std::size_t t = 0; t < kBlock; ++t) {
+            uint64_t mv = 0, mr = 0;
+            for (unsigned k = 0; k < M; ++k) {
+                mv |= (uint64_t)pv[t * M + k] << k;
+                mr |= (uint64_t)pr[t * M + k] << k;
+            }
+            m_valid[t] = mv;
+            m_ready[t] = mr;
+        }
+    }
+
+    // Lane k of cycle t is element k of these M-wide rows
+    const uint32_t* a(std::size_t t)   const { return m_a + t * M; }
+    const uint32_t* b(std::size_t t)   const { return m_b + t * M; }
+    const uint32_t* sum(std::size_t t) const { return m_sum + t * M; }
+    uint64_t        valid(std::size_t t) const { return m_valid[t]; }
+    uint64_t        ready(std::size_t t) const { return m_ready[t]; }
+
+private:
+    static constexpr uint64_t kGamma = 0x9E3779B97F4A7C15ull;
+
+    static inline uint64_t mix64(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t threshold(unsigned pct) {
+        if (pct >= 100) return 1ull << 32;
+        return ((uint64_t)pct << 32) / 100;
+    }
+
+    uint64_t m_key[3];
+    uint64_t m_thr_valid = 0, m_thr_ready = 0;
+    uint64_t m_ctr = 0;
+
+    alignas(64) uint32_t m_a[kBlock * M];
+    alignas(64) uint32_t m_b[kBlock * M];
+    alignas(64) uint32_t m_sum[kBlock * M];
+    alignas(64) uint8_t  m_tmp_v[kBlock * M];
+    alignas(64) uint8_t  m_tmp_r[kBlock * M];
+    uint64_t m_valid[kBlock];
+    uint64_t m_ready[kBlock];
+};
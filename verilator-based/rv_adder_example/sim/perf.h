@@ -0,0 +1,82 @@
+// sim/perf.h
+// Cheap always-on simulation performance counters.
+//
+// Time is read from the TSC (rdtsc on x86, steady_clock elsewhere) on one
+// cycle out of kSamplePeriod only, so the cost on the hot path is one
+// counter compare per cycle. Sampled ticks are scaled by the sampling ratio
+// and converted to seconds with a TSC rate calibrated against the run's own
+// wall clock.
+#pragma once
+
+#include "verilated.h"
+
+#include <chrono>
+#include <cstdint>
+
+#include <sys/resource.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#endif
+
+static inline uint64_t perf_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::steady_clock::now().time_since_epoch().count();
+#endif
+}
+
+// Peak resident set size of the whole process, in KiB
+static inline long perf_peak_rss_kb() {
+    struct rusage ru;
+    if (getrusage(RUSAGE_SELF, &ru) != 0) return -1;
+    return ru.ru_maxrss;   // KiB on Linux
+}
+
+enum PerfBucket : unsigned {
+    P_EVAL,        // top->eval()
+    P_TRACE,       // trace step / flight recorder sample
+    P_STIM,        // stimulus block generation
+    P_SB,          // scoreboard expect/check
+    P_COUNT
+};
+
+struct PerfCounters {
+    static constexpr uint64_t kSamplePeriod = 64;   // power of two
+
+    uint64_t ticks[P_COUNT] = {};   // raw TSC ticks (sampled buckets unscaled)
+    uint64_t sampled = 0;           // cycles that were timed
+    uint64_t seen    = 0;           // cycles offered to sample()
+
+    uint64_t tsc0 = 0, tsc1 = 0;
+    std::chrono::steady_clock::time_point wall0, wall1;
+
+    void start() { wall0 = std::chrono::steady_clock::now(); tsc0 = perf_ticks(); }
+    void stop()  { tsc1 = perf_ticks(); wall1 = std::chrono::steady_clock::now(); }
+
+    // True on the cycles whose phases should be timed
+    inline bool sample() {
+        if (VL_LIKELY((++seen & (kSamplePeriod - 1)) != 0)) return false;
+        ++sampled;
+        return true;
+    }
+
+    double wall_s() const { return std::chrono::duration<double>(wall1 - wall0).count(); }
+
+    // Calibrated ticks per second for this run
+    double tick_hz() const {
+        const double w = wall_s();
+        return (w > 0 && tsc1 > tsc0) ? (double)(tsc1 - tsc0) / w : 0.0;
+    }
+
+    // Estimated seconds in a bucket; per-cycle buckets are scaled up by the
+    // sampling ratio, P_STIM is timed on every block and is exact
+    double secs(PerfBucket b) const {
+        const double hz = tick_hz();
+        if (hz <= 0) return 0.0;
+        double t = (double)ticks[b];
+        if (b != P_STIM && sampled) t *= (double)seen / (double)sampled;
+        return t / hz;
+    }
+};
@@ -0,0 +1,124 @@
+// sim/scoreboard.h
+// In-order scoreboard on a fixed ring: no allocation, no I/O on the hot path.
+//
+//   expect(v, tag)   on input accept   (push expected value)
+//   check(got, tag)  on output transfer (pop + compare)
+//   report(...)      once per phase     (print the batch of logged failures)
+//
+// Failures are counted on the hot path; only the first kLogDepth of each
+// batch are copied into a fixed log by an out-of-line cold function, and
+// nothing is printed until report(). Capacity must be a power of two and
+// bound the number of transactions in flight (DUT storage + 1).
+#pragma once
+
+#include "verilated.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <type_traits>
+
+// Value printer used by report(); overload for non-integral transaction types
+template <class T>
+inline typename std::enable_if<std::is_integral<T>::value>::type
+sb_print(std::FILE* f, const T& v) {
+    std::fprintf(f, "%llu", (unsigned long long)v);
+}
+
+template <class T, std::size_t Capacity>
+class Scoreboard {
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0,
+                  "Scoreboard capacity must be a power of two");
+public:
+    enum class Kind : uint8_t {
+        Mismatch,     // got != expected
+        Unexpected,   // output with nothing expected
+        Overflow,     // more than Capacity in flight (expectation dropped)
+        Missing,      // expectation never produced (see finish())
+    };
+    struct Event {
+        Kind     kind;
+        uint64_t tag;   // caller's cycle/transaction number
+        T        got;
+        T        exp;
+    };
+    static constexpr std::size_t kLogDepth = 16;
+
+    inline void expect(const T& v, uint64_t tag) {
+        if (VL_UNLIKELY(m_tail - m_head == Capacity)) { fail(Kind::Overflow, tag, v, v); return; }
+        m_ring[m_tail++ & (Capacity - 1)] = v;
+    }
+
+    // Returns false on failure so the caller can fire triggers
+    inline bool check(const T& got, uint64_t tag) {
+        ++m_checked;
+        if (VL_UNLIKELY(m_head == m_tail)) { fail(Kind::Unexpected, tag, got, got); return false; }
+        const T& exp = m_ring[m_head++ & (Capacity - 1)];
+        if (VL_LIKELY(got == exp)) return true;
+        fail(Kind::Mismatch, tag, got, exp);
+        return false;
+    }
+
+    // End of test: every expectation still queued is a missing output
+    void finish(uint64_t tag) {
+        while (m_head != m_tail) {
+            const T& exp = m_ring[m_head++ & (Capacity - 1)];
+            fail(Kind::Missing, tag, exp, exp);
+        }
+    }
+
+    bool        empty()   const { return m_head == m_tail; }
+    std::size_t size()    const { return (std::size_t)(m_tail - m_head); }
+    uint64_t    pushed()  const { return m_tail; }
+    uint64_t    checked() const { return m_checked; }
+    uint64_t    errors()  const { return m_errors; }
+
+    // Print this batch's logged failures under `label`, then start a new batch.
+    // Returns the number of failures in the batch.
+    uint64_t report(std::FILE* f, const char* label) {
+        const uint64_t n = m_errors - m_batch_base;
+        for (std::size_t i = 0; i < m_nlog; ++i) {
+            const Event& e = m_log[i];
+            std::fprintf(f, "%s @%llu ", label, (unsigned long long)e.tag);
+            switch (e.kind) {
+            case Kind::Mismatch:
+                std::fprintf(f, "got=");  sb_print(f, e.got);
+                std::fprintf(f, " exp="); sb_print(f, e.exp);
+                break;
+            case Kind::Unexpected:
+                std::fprintf(f, "Unexpected output (empty scoreboard) got="); sb_print(f, e.got);
+                break;
+            case Kind::Overflow:
+                std::fprintf(f, "Scoreboard overflow, dropped exp="); sb_print(f, e.exp);
+                break;
+            case Kind::Missing:
+                std::fprintf(f, "Missing output exp="); sb_print(f, e.exp);
+                break;
+            }
+            std::fputc('\n', f);
+        }
+        if (n > m_nlog)
+            std::fprintf(f, "%s ... %llu more failures not shown\n", label,
+                         (unsigned long long)(n - m_nlog));
+        m_batch_base = m_errors;
+        m_nlog = 0;
+        return n;
+    }
+
+private:
+#if defined(__GNUC__)
+    __attribute__((cold, noinline))
+#endif
+    void fail(Kind k, uint64_t tag, const T& got, const T& exp) {
+        ++m_errors;
+        if (m_nlog < kLogDepth) m_log[m_nlog++] = Event{k, tag, got, exp};
+    }
+
+    T           m_ring[Capacity] = {};
+    uint64_t    m_head = 0, m_tail = 0;   // free-running; index = x & (Capacity-1)
+    uint64_t    m_checked = 0;
+    uint64_t    m_errors = 0;
+    uint64_t    m_batch_base = 0;
+    Event       m_log[kLogDepth] = {};
+    std::size_t m_nlog = 0;
+};
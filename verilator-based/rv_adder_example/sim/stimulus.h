@@ -0,0 +1,168 @@
+// sim/stimulus.h
+// Block-wise random stimulus + golden model for the random phase.
+//
+// fill() produces kBlock records {a, b, present, ready} and their expected
+// sums in a few straight-line passes over structure-of-arrays storage, so
+// the compiler can vectorize them; the cycle loop then only reads.
+//
+// Randomness is counter-based (SplitMix64 finalizer over key + counter), so
+// element i of stream s depends only on (seed, s, i): reproducible for a
+// seed, no serial state dependency between lanes, and independent of the
+// block size. Valid/ready are Bernoulli draws against a fixed-point
+// threshold, packed into 64-bit masks.
+//
+// The block is templated on the adder width W (adder_word.h). Up to 64 bits
+// operands are uint64_t and the golden pass is a masked add; wider operands
+// take one 64-bit draw per limb (counter (i * limbs + j)) and the golden
+// pass is Word<W>::add, a fixed-length carry chain.
+#pragma once
+
+#include "adder_word.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+template <unsigned W>
+class StimulusBlock {
+public:
+    using AW = Word<W>;
+    using Op = typename AW::type;
+
+    static constexpr std::size_t kBlock = 4096;            // records per fill()
+    static constexpr std::size_t kWords = kBlock / 64;
+    static_assert(kBlock % 64 == 0, "block must be a whole number of mask words");
+
+    // Random operands use the low op_bits bits (<= W); sums are W bits
+    StimulusBlock(uint64_t seed, unsigned op_bits, unsigned p_valid_pct, unsigned p_ready_pct)
+        : m_op_bits(op_bits < W ? op_bits : W), m_op_mask(AW::mask(m_op_bits)) {
+        // One key per stream so a/b/valid/ready never share counters
+        for (unsigned s = 0; s < 4; ++s) m_key[s] = mix64(seed * 4 + s + 0x632BE59BD9B4E019ull);
+        set_probs(p_valid_pct, p_ready_pct);
+    }
+
+    // Takes effect from the next fill()
+    void set_probs(unsigned p_valid_pct, unsigned p_ready_pct) {
+        m_thr_valid = threshold(p_valid_pct);
+        m_thr_ready = threshold(p_ready_pct);
+    }
+
+    // From the next fill(), force the top operand bit on (so every add of
+    // full-width operands carries out), or back to plain uniform operands
+    void set_operand_top(bool on) { m_op_or = on && m_op_bits ? AW::bit(m_op_bits - 1) : Op{}; }
+
+    // Generate the next block of stimulus and expected results
+    void fill() {
+        const uint64_t base = m_ctr;
+        m_ctr += kBlock;
+
+        Op*      __restrict a   = m_a;
+        Op*      __restrict b   = m_b;
+        Op*      __restrict sum = m_sum;
+        uint8_t* __restrict pv  = m_tmp_v;
+        uint8_t* __restrict pr  = m_tmp_r;
+        const uint64_t ka = m_key[0], kb = m_key[1], kv = m_key[2], kr = m_key[3];
+        const uint64_t tv = m_thr_valid, tr = m_thr_ready;
+        const Op mask = m_op_mask, omask = m_op_or;
+
+        // Operands and Bernoulli draws (independent lanes)
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            const uint64_t c = (base + i) * kGamma;
+            if constexpr (!AW::kWide) {
+                a[i] = (mix64(ka + c) & mask) | omask;
+                b[i] = (mix64(kb + c) & mask) | omask;
+            } else {
+                for (std::size_t j = 0; j < kLimbs; ++j) {
+                    const uint64_t cj = ((base + i) * kLimbs + j) * kGamma;
+                    put_limb(a[i], j, mix64(ka + cj));
+                    put_limb(b[i], j, mix64(kb + cj));
+                }
+                a[i] = AW::and_or(a[i], mask, omask);
+                b[i] = AW::and_or(b[i], mask, omask);
+            }
+            pv[i] = (uint8_t)((mix64(kv + c) >> 32) < tv);
+            pr[i] = (uint8_t)((mix64(kr + c) >> 32) < tr);
+        }
+
+        // Golden model for the whole block in one pass
+        for (std::size_t i = 0; i < kBlock; ++i) sum[i] = AW::add(a[i], b[i]);
+
+        // Pack the draws into bit masks
+        for (std::size_t w = 0; w < kWords; ++w) {
+            uint64_t mv = 0, mr = 0;
+            for (unsigned j = 0; j < 64; ++j) {
+                mv |= (uint64_t)pv[w * 64 + j] << j;
+                mr |= (uint64_t)pr[w * 64 + j] << j;
+            }
+            m_valid[w] = mv;
+            m_ready[w] = mr;
+        }
+    }
+
+    const Op& a(std::size_t i)      const { return m_a[i]; }
+    const Op& b(std::size_t i)      const { return m_b[i]; }
+    const Op& sum(std::size_t i)    const { return m_sum[i]; }
+    bool     present(std::size_t i) const { return (m_valid[i >> 6] >> (i & 63)) & 1; }
+    bool     ready(std::size_t i)   const { return (m_ready[i >> 6] >> (i & 63)) & 1; }
+
+    // First index >= i with in_valid drawn, kBlock if there is none (idle spans)
+    std::size_t next_present(std::size_t i) const {
+        std::size_t w = i >> 6;
+        uint64_t    m = m_valid[w] & (~0ull << (i & 63));
+        while (!m) {
+            if (++w == kWords) return kBlock;
+            m = m_valid[w];
+        }
+        return (w << 6) + (std::size_t)__builtin_ctzll(m);
+    }
+
+    // Cycles with out_ready drawn in [i, i + n), i + n <= kBlock
+    std::size_t ready_count(std::size_t i, std::size_t n) const {
+        std::size_t c = 0;
+        for (std::size_t end = i + n; i < end;) {
+            const std::size_t w = i >> 6, lo = i & 63, hi = std::min<std::size_t>(64, lo + (end - i));
+            const uint64_t m = (hi == 64 ? ~0ull : ((1ull << hi) - 1)) & (~0ull << lo);
+            c += (std::size_t)__builtin_popcountll(m_ready[w] & m);
+            i += hi - lo;
+        }
+        return c;
+    }
+
+private:
+    static constexpr uint64_t kGamma = 0x9E3779B97F4A7C15ull;
+    static constexpr std::size_t kLimbs = (W + 63) / 64;   // 64-bit draws per wide operand
+
+    static inline void put_limb(Op& v, std::size_t j, uint64_t x) {
+        if constexpr (AW::kWide) {
+            v.w[2 * j] = (uint32_t)x;
+            if (2 * j + 1 < AW::kWords) v.w[2 * j + 1] = (uint32_t)(x >> 32);
+        }
+    }
+
+    static inline uint64_t mix64(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // P(u32 < thr) == pct/100 for a uniform 32-bit u32
+    static uint64_t threshold(unsigned pct) {
+        if (pct >= 100) return 1ull << 32;
+        return ((uint64_t)pct << 32) / 100;
+    }
+
+    uint64_t m_key[4];
+    unsigned m_op_bits;
+    Op       m_op_mask;
+    Op       m_op_or{};
+    uint64_t m_thr_valid = 0, m_thr_ready = 0;
+    uint64_t m_ctr = 0;
+
+    alignas(64) Op       m_a[kBlock];
+    alignas(64) Op       m_b[kBlock];
+    alignas(64) Op       m_sum[kBlock];
+    alignas(64) uint8_t  m_tmp_v[kBlock];
+    alignas(64) uint8_t  m_tmp_r[kBlock];
+    uint64_t m_valid[kWords];
+    uint64_t m_ready[kWords];
+};
@@ -0,0 +1,79 @@
+// sim/tb_args.h
+// Runtime options for the harness, so one Verilated build serves a whole
+// regression matrix.
+//
+// Accepts "+name=value" (plusarg style, as seen by Verilated::commandArgs) and
+// "--name=value"; a bare "+name" / "--name" means 1. The first occurrence wins.
+// "+verilator+..." arguments belong to the Verilator runtime and are ignored
+// here. Every lookup marks its name as known, so after parsing unknown()
+// lists misspelt options instead of silently running the default config.
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <set>
+#include <string>
+#include <vector>
+
+class TbArgs {
+public:
+    TbArgs(int argc, char** argv) {
+        for (int i = 1; i < argc; ++i) {
+            std::string a = argv[i];
+            std::size_t skip = 0;
+            if (a.rfind("+verilator+", 0) == 0) continue;
+            if (a.rfind("--", 0) == 0)     skip = 2;
+            else if (a.rfind("+", 0) == 0) skip = 1;
+            else { m_errors.push_back("unexpected argument '" + a + "'"); continue; }
+            const std::size_t eq = a.find('=');
+            Opt o;
+            o.name  = a.substr(skip, eq == std::string::npos ? std::string::npos : eq - skip);
+            o.value = eq == std::string::npos ? "1" : a.substr(eq + 1);
+            o.given = a;
+            m_opts.push_back(o);
+        }
+    }
+
+    bool has(const char* name) const { return find(name) != nullptr; }
+
+    uint64_t u64(const char* name, uint64_t def) const {
+        const Opt* o = find(name);
+        if (!o) return def;
+        char* end = nullptr;
+        const uint64_t v = std::strtoull(o->value.c_str(), &end, 0);
+        if (o->value.empty() || *end != '\0') {
+            m_errors.push_back("'" + o->given + "' is not a number");
+            return def;
+        }
+        return v;
+    }
+
+    std::string str(const char* name, const std::string& def) const {
+        const Opt* o = find(name);
+        return o ? o->value : def;
+    }
+
+    // Options no lookup asked for (call after all parsing)
+    std::vector<std::string> unknown() const {
+        std::vector<std::string> out;
+        for (const Opt& o : m_opts)
+            if (!m_known.count(o.name)) out.push_back(o.given);
+        return out;
+    }
+
+    const std::vector<std::string>& errors() const { return m_errors; }
+
+private:
+    struct Opt { std::string name, value, given; };
+
+    const Opt* find(const char* name) const {
+        m_known.insert(name);
+        for (const Opt& o : m_opts)
+            if (o.name == name) return &o;
+        return nullptr;
+    }
+
+    std::vector<Opt>                 m_opts;
+    mutable std::set<std::string>    m_known;
+    mutable std::vector<std::string> m_errors;
+};
@@ -0,0 +1,247 @@
+// sim/tb_lanes.cpp
+// Harness for rtl/adder_lanes.sv: M independent adder_rv_simple lanes, built
+// with -GM=LANES (make run-lanes LANES=M THREADS=T).
+//
+// Every cycle drives all lanes from one row of LaneStimulus (packed valid /
+// ready masks, lane-contiguous operands) and keeps one in-order scoreboard
+// per lane; accepts and transfers are walked as set bits of the pre-edge
+// handshake masks. Same clocking rules as tb_main.cpp: drive on the low phase,
+// decide accept/transfer from the pre-edge values, then clock.
+//
+// The run report (logs/perf_lanes.json) holds lanes, model threads, cycles/s
+// and lane-cycles/s, so a LANES x THREADS sweep (make bench-lanes) shows how
+// the multithreaded eval() scales with design size.
+
+#include "verilated.h"
+#if VM_COVERAGE
+#include "verilated_cov.h"
+#endif
+#include "Vadder_lanes.h"
+
+#include "lane_stimulus.h"
+#include "perf.h"
+#include "scoreboard.h"
+#include "tb_args.h"
+#include "trace_ctl.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+#ifndef LANES
+#define LANES 8                 // must match the model's -GM (the Makefile passes both)
+#endif
+
+constexpr unsigned M = LANES;
+static_assert(M >= 1 && M <= 64, "handshake masks are one 64-bit word");
+
+// Expected sums in flight per lane (DUT holds 2, one more may be accepted at the edge)
+using LaneScoreboard = Scoreboard<uint64_t, 8>;
+
+// Packed M x 32-bit port <-> lane array. Up to 64 bits Verilator uses an
+// integer (lane k at bit 32k), wider ports are VlWide with one word per lane.
+template <class Port>
+static inline void put_lanes(Port& port, const uint32_t* v) {
+    if constexpr (std::is_integral<Port>::value) {
+        uint64_t x = 0;
+        for (unsigned k = 0; k < M; ++k) x |= (uint64_t)v[k] << (32 * k);
+        port = (Port)x;
+    } else {
+        for (unsigned k = 0; k < M; ++k) port[k] = v[k];
+    }
+}
+
+template <class Port>
+static inline uint32_t lane_of(const Port& port, unsigned k) {
+    if constexpr (std::is_integral<Port>::value) return (uint32_t)((uint64_t)port >> (32 * k));
+    else                                         return (uint32_t)port[k];
+}
+
+struct LaneBench {
+    std::unique_ptr<VerilatedContext>        ctx;
+    std::unique_ptr<Vadder_lanes>            top;
+    std::unique_ptr<TraceCtl<Vadder_lanes>>  trace;
+    LaneScoreboard sb[M];
+    vluint64_t main_time = 0;
+};
+
+static inline void half_step(LaneBench& b) {
+    b.top->eval();
+    ++b.main_time;
+    b.trace->step(b.main_time);
+}
+
+// One clock cycle for all lanes
+static inline void lane_cycle(LaneBench& b, uint64_t valid, const uint32_t* a, const uint32_t* bv,
+                              const uint32_t* exp, uint64_t ready) {
+    Vadder_lanes* top = b.top.get();
+
+    // ----- Low phase: drive every lane for the upcoming edge
+    top->clk       = 0;
+    top->in_valid  = valid;
+    put_lanes(top->in_a, a);
+    put_lanes(top->in_b, bv);
+    top->out_ready = ready;
+    half_step(b);
+
+    const uint64_t tag  = b.main_time / 2;
+    const uint64_t send = (uint64_t)top->out_valid & (uint64_t)top->out_ready;
+    uint32_t pre_sum[M];
+    for (uint64_t m = send; m; m &= m - 1) {
+        const unsigned k = (unsigned)__builtin_ctzll(m);
+        pre_sum[k] = lane_of(top->out_sum, k);
+    }
+    for (uint64_t m = (uint64_t)top->in_valid & (uint64_t)top->in_ready; m; m &= m - 1) {
+        const unsigned k = (unsigned)__builtin_ctzll(m);
+        b.sb[k].expect(exp[k], tag);
+    }
+
+    // ----- Rising edge
+    top->clk = 1;
+    half_step(b);
+
+    for (uint64_t m = send; m; m &= m - 1) {
+        const unsigned k = (unsigned)__builtin_ctzll(m);
+        if (VL_UNLIKELY(!b.sb[k].check(pre_sum[k], tag))) b.trace->trigger(b.main_time);
+    }
+}
+
+static bool all_idle(const LaneBench& b) {
+    if (b.top->out_valid) return false;
+    for (const LaneScoreboard& s : b.sb)
+        if (!s.empty()) return false;
+    return true;
+}
+
+static uint64_t lane_report(LaneBench& b, const char* phase) {
+    uint64_t n = 0;
+    for (unsigned k = 0; k < M; ++k) {
+        char lbl[64];
+        std::snprintf(lbl, sizeof lbl, "[lane %u %s]", k, phase);
+        n += b.sb[k].report(stderr, lbl);
+    }
+    return n;
+}
+
+static void usage() {
+    std::printf(
+"Usage: sim_adder_lanes [options]   (each option as +name=value or --name=value)\n"
+"\n"
+"  +seed=S              stimulus seed (default 1)\n"
+"  +cycles=N            random-phase cycles (default 100000)\n"
+"  +p_valid=P           percent of cycles with in_valid asserted, per lane (default 70)\n"
+"  +p_ready=P           percent of cycles with out_ready asserted, per lane (default 60)\n"
+"  +trace=0|1           FST tracing (default 0)\n"
+"  +trace_start=C       first traced cycle (default 0)\n"
+"  +trace_stop=C        stop tracing at cycle C (default: end of run)\n"
+"  +wave=PATH           waveform (default logs/wave_lanes.fst)\n"
+"  +cov=PATH            coverage data (default logs/coverage_lanes.dat)\n"
+"  +perf=PATH           run report (default logs/perf_lanes.json)\n"
+"  +help                this text\n"
+"\n"
+"Built for %u lanes of 32 bits.\n", M);
+}
+
+int main(int argc, char** argv) {
+    Verilated::commandArgs(argc, argv);
+
+    const TbArgs args(argc, argv);
+    if (args.has("help")) { usage(); return 0; }
+
+    const uint64_t    seed      = args.u64("seed", 1);
+    const uint64_t    cycles    = args.u64("cycles", 100000);
+    const unsigned    p_valid   = (unsigned)std::min<uint64_t>(100, args.u64("p_valid", 70));
+    const unsigned    p_ready   = (unsigned)std::min<uint64_t>(100, args.u64("p_ready", 60));
+    const std::string cov_path  = args.str("cov", "logs/coverage_lanes.dat");
+    const std::string perf_path = args.str("perf", "logs/perf_lanes.json");
+    TraceOpts topts;
+    topts.enable = args.u64("trace", 0) != 0;
+    topts.start  = args.u64("trace_start", topts.start);
+    topts.stop   = args.u64("trace_stop", topts.stop);
+    topts.path   = args.str("wave", "logs/wave_lanes.fst");
+
+    bool bad = false;
+    for (const std::string& e : args.errors())  { std::fprintf(stderr, "[TB] %s\n", e.c_str()); bad = true; }
+    for (const std::string& u : args.unknown()) { std::fprintf(stderr, "[TB] unknown option '%s' (see +help)\n", u.c_str()); bad = true; }
+    if (bad) return 2;
+
+    LaneBench bench;
+    bench.ctx = std::make_unique<VerilatedContext>();
+    bench.ctx->traceEverOn(topts.enable);
+    bench.top   = std::make_unique<Vadder_lanes>(bench.ctx.get(), "TOP");
+    bench.trace = std::make_unique<TraceCtl<Vadder_lanes>>(bench.top.get(), topts);
+    Vadder_lanes* top = bench.top.get();
+
+    const uint32_t zeros[M] = {};
+    const uint64_t all = (M == 64) ? ~0ull : ((1ull << M) - 1);
+    auto stim = std::make_unique<LaneStimulus<M>>(seed, p_valid, p_ready);
+
+    // ---- Reset for a few cycles
+    top->clk = 0; top->rst_n = 0; top->in_valid = 0; top->out_ready = 0;
+    for (int i = 0; i < 4; ++i) {
+        top->clk = 0; half_step(bench);
+        top->clk = 1; half_step(bench);
+    }
+    top->rst_n = 1;
+
+    // ---- Random streaming with per-lane backpressure
+    const auto t0 = std::chrono::steady_clock::now();
+    const uint64_t c0 = bench.main_time / 2;
+    for (uint64_t t = 0; t < cycles; ++t) {
+        const std::size_t i = (std::size_t)(t % LaneStimulus<M>::kBlock);
+        if (i == 0) stim->fill();
+        lane_cycle(bench, stim->valid(i), stim->a(i), stim->b(i), stim->sum(i), stim->ready(i));
+        if (VL_UNLIKELY(bench.ctx->gotFinish())) break;
+    }
+    uint64_t errors = lane_report(bench, "RND");
+
+    // ---- Drain: sources idle, every sink ready
+    for (int i = 0; i < 64 && !all_idle(bench); ++i)
+        lane_cycle(bench, 0, zeros, zeros, zeros, all);
+    uint64_t accepted = 0;
+    for (LaneScoreboard& s : bench.sb) {
+        s.finish(bench.main_time / 2);
+        accepted += s.pushed();
+    }
+    errors += lane_report(bench, "DRN");
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    const uint64_t ncyc = bench.main_time / 2 - c0;
+
+    bench.trace->close();
+    top->final();
+#if VM_COVERAGE
+    bench.ctx->coveragep()->write(cov_path.c_str());
+#endif
+
+    auto rate = [&](double n) { return secs > 0 ? n / secs : 0.0; };
+    if (std::FILE* f = std::fopen(perf_path.c_str(), "w")) {
+        std::fprintf(f, "{\n");
+#ifdef VERILATOR_VERSION
+        std::fprintf(f, "  \"verilator\": \"%s\",\n", VERILATOR_VERSION);
+#endif
+        std::fprintf(f, "  \"lanes\": %u,\n  \"threads\": %u,\n  \"seed\": %llu,\n  \"errors\": %llu,\n",
+                     M, top->threads(), (unsigned long long)seed, (unsigned long long)errors);
+        std::fprintf(f, "  \"peak_rss_kb\": %ld,\n", perf_peak_rss_kb());
+        std::fprintf(f, "  \"total\": {\"cycles\": %llu, \"wall_s\": %.6f, \"cycles_per_s\": %.1f, "
+                        "\"lane_cycles_per_s\": %.1f, \"accepted\": %llu, \"accepted_per_s\": %.1f}\n}\n",
+                     (unsigned long long)ncyc, secs, rate((double)ncyc), rate((double)ncyc * M),
+                     (unsigned long long)accepted, rate((double)accepted));
+        std::fclose(f);
+    } else {
+        std::fprintf(stderr, "[TB] cannot write %s\n", perf_path.c_str());
+    }
+
+    std::printf("PERF: %u lanes x %llu cycles, %u threads, %.0f cycles/s, %.0f transactions/s -> %s\n",
+                M, (unsigned long long)ncyc, top->threads(), rate((double)ncyc),
+                rate((double)accepted), perf_path.c_str());
+    if (errors) {
+        std::fprintf(stderr, "TEST FAIL: %llu mismatches\n", (unsigned long long)errors);
+        return 1;
+    }
+    std::printf("TEST PASS\n");
+    return 0;
+}
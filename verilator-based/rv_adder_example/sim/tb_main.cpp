@@ -1,34 +1,464 @@
 // sim/tb_main.cpp
 // Verilator 5.031: FST tracing + coverage + O3 (set via Makefile)
+//
+// Everything is configured at run time (+help lists the options), so one
+// build serves a whole regression matrix: default is one seed with waves in
+// logs/wave.fst and coverage in logs/coverage.dat; +seeds=N runs N independent
+// model instances on a worker pool or, with +fork=1, as forked children of
+// one warmed-up model.
+//
+// Scenarios are test cases in a registry (test_registry.h): each TB_TEST
+// below registers itself and continues from the post-warm-up state (reset +
+// directed smoke + drain). +test=LIST picks them by name or glob (default
+// "random", the original sequence), +list prints them, and several tests run
+// as one matrix of (test, seed) jobs over the same compiled model.
+//
+// Every run writes a machine-readable report (logs/perf.json, next to the
+// coverage data): cycles/s, accepted/emitted transactions/s, sampled time
+// split into eval/trace/stimulus/scoreboard, and peak RSS.
+//
+// Idle spans of the random phase (no in_valid drawn, DUT empty, nothing
+// expected) are not evaluated: time jumps over them in one step (+idle_skip).
+//
+// +cov_window=K closes the loop from coverage to stimulus: every K cycles the
+// live coverage counters steer valid/ready and the operands towards the
+// points still uncovered (cov_feedback.h), and the cycle at which coverage
+// closed is reported next to the coverage data.
+//
+// Each test body also measures the DUT (dut_stats.h): accept-to-emit
+// latency, in_ready-low stall runs and buffer occupancy in fixed-bucket
+// histograms, and achieved against offered throughput, under "dut" in
+// perf.json.
+//
+// With +seeds each seed writes its own coverage shard (coverage_s<seed>.dat);
+// at the end the shards are merged in parallel (cov_merge.h) into the plain
+// coverage path, which is what `make coverage` annotates.
+//
+// +txlog=PATH records every evaluated cycle (or, +txlog_mode=txn, every
+// accepted transaction) into a compact binary log behind a background writer
+// (txlog.h). `txlog_replay` cuts a window out of it, e.g. the cycles before
+// the first mismatch, as input vectors for the file-based Questa flow or as a
+// shorter log that +replay=PATH drives through a fully traced rerun.
+//
+// The datapath width is a build parameter: the Makefile passes W to the RTL
+// (-GW=W) and to this file (-DTB_W=W). Every value path is templated on it
+// through Word<W> (adder_word.h): native 64-bit arithmetic up to 64 bits,
+// fixed-length multi-word carry chains on Verilator's VlWide ports above.
+// The transaction log (+txlog / +replay) stores 64-bit fields and is only
+// available up to W = 64.
+//
+// Soak runs (10^10+ cycles) keep memory and disk constant: the scoreboard,
+// flight recorder and DUT statistics are fixed-size already, +trace_segment_mb
+// rotates the trace over a few size-capped FST segments (trace_ctl.h), and
+// +checkpoint=N saves model + harness state every N random-phase cycles
+// (checkpoint.h, needs a --savable model). +resume=1 continues from the
+// checkpoint when one exists, so rerunning the same command line picks a
+// pre-empted job up where it was (a clean finish removes the checkpoint, so
+// the next run starts fresh); +progress=S prints cycles/s as it goes.
+//
+// With +seeds each worker is pinned to one CPU of the process affinity mask
+// (so `numactl -C ...` still decides which cores are used), and every seed
+// gets its own VerilatedContext, so models never share simulation state.
 
 #include "verilated.h"
-#include "verilated_fst_c.h"
+#if VM_COVERAGE
 #include "verilated_cov.h"
+#endif
 #include "Vadder_rv_simple.h"   // top module name matches rtl/adder_rv_simple.sv
 
+#include "adder_word.h"
+#include "checkpoint.h"
+#include "cov_feedback.h"
+#include "cov_merge.h"
+#include "dut_stats.h"
+#include "flight_recorder.h"
+#include "perf.h"
+#include "scoreboard.h"
+#include "stimulus.h"
+#include "tb_args.h"
+#include "test_registry.h"
+#include "trace_ctl.h"
+#include "txlog.h"
+#include "vecstore.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
 #include <cstdint>
 #include <cstdio>
-#include <queue>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <random>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#ifndef TB_W
+#define TB_W 32                 // must match the model's -GW (Makefile: W)
+#endif
+constexpr unsigned W = TB_W;
+using AW = Word<W>;
+using Op = AW::type;            // operand / sum word
+
+static_assert(sizeof(std::remove_reference<decltype(std::declval<Vadder_rv_simple&>().out_sum)>::type)
+                  == AW::kPortBytes,
+              "TB_W does not match the width the model was verilated with (-GW)");
+
+// Expected sums in flight: DUT holds 2, one more may be accepted at the edge
+using SumScoreboard = Scoreboard<Op, 8>;
+
+struct SoakState;
+
+// One DUT instance with its own simulation context, tracer and time base
+struct Bench {
+    std::unique_ptr<VerilatedContext> ctx;
+    std::unique_ptr<Vadder_rv_simple> top;
+    std::unique_ptr<TraceCtl<Vadder_rv_simple>> trace;
+    std::unique_ptr<FlightRecorder<W>> flight; // null unless +flight
+    std::unique_ptr<TxLogWriter>      txlog;   // null unless +txlog
+    SumScoreboard sb;                          // expected sums (pushed on accept, popped on send)
+    DutStats      dut;                         // DUT latency/stall/occupancy (test body)
+    bool          dut_on = false;
+    uint64_t      check_errors = 0;            // protocol checks of directed tests (test_check)
+    PerfCounters  perf;
+    vluint64_t main_time = 0;
+    uint64_t   seed      = 0;
+    uint64_t   skipped   = 0;   // idle cycles advanced without eval()
+    uint64_t   cov_points = 0, cov_covered = 0;            // last feedback snapshot
+    uint64_t   cov_closure = CovFeedback::kNone, cov_last_new = 0;
+    std::unique_ptr<SoakState> resume;     // restored checkpoint, until random_phase takes it
+};
+
+// Harness half of a checkpoint, taken at a random-phase block boundary (the
+// model half is Verilator's). The generator's block is saved whole; its
+// counter state is what matters, the next fill() overwrites the records.
+struct SoakState {
+    static_assert(std::is_trivially_copyable<StimulusBlock<W>>::value, "generator is saved as raw bytes");
 
-static vluint64_t main_time = 0;
+    uint64_t      seed;
+    unsigned      p_valid, p_ready, op_width;
+    uint64_t      t;                  // random-phase cycles done
+    uint64_t      main_time, skipped, check_errors;
+    unsigned      trace_segment;
+    SumScoreboard sb;
+    DutStats      dut;
+    alignas(64) unsigned char stim[sizeof(StimulusBlock<W>)];
+};
 
-static inline void dump_step(VerilatedFstC* tfp) {
-    tfp->dump(++main_time);   // dump each half-cycle
+// Outcome of one (test, seed) job
+struct RunResult {
+    uint64_t seed   = 0;
+    unsigned test   = 0;   // registry index
+    int      errors = 0;
+    uint64_t cycles = 0;   // clock cycles simulated (reset + directed + random + drains)
+    double   secs   = 0.0; // wall time incl. model construction
+    uint64_t accepted = 0; // input transfers
+    uint64_t emitted  = 0; // output transfers
+    uint64_t skipped  = 0; // part of cycles that were fast-forwarded
+    uint64_t cov_points = 0, cov_covered = 0;   // 0 points = not measured (+cov_window)
+    uint64_t cov_closure = CovFeedback::kNone;  // cycle all points were covered
+    uint64_t cov_last_new = 0;                  // cycle of the last newly covered point
+    uint64_t txlog_records = 0, txlog_bytes = 0;
+    unsigned p_valid = 0, p_ready = 0;          // offered load (percent), for the DUT report
+    DutStats dut;
+    PerfCounters perf;     // simulation loop only
+};
+
+// Options shared by every seed of a run
+struct RunOpts {
+    TraceOpts   trace;
+    uint64_t    flight      = 0;   // flight recorder depth in cycles, 0 = off
+    uint64_t    flight_post = 0;
+    uint64_t    cycles      = 2000;
+    unsigned    p_valid     = 70;  // percent
+    unsigned    p_ready     = 60;  // percent
+    unsigned    op_width    = W;   // random operand bits
+    bool        idle_skip   = true;
+    bool        dut_stats   = true;  // DUT latency/stall/occupancy histograms
+    uint64_t    cov_window  = 0;     // coverage feedback period in cycles, 0 = off
+    bool        cov_adapt   = true;  // 0: only measure closure, never retune
+    bool        cov_stop    = false; // end the random phase at closure
+    bool        cov_merge   = true;  // +seeds: merge the per-seed shards into cov_path
+    bool        cov_keep    = true;  // keep the shards after merging
+    std::string cov_path    = "logs/coverage.dat";
+    std::string perf_path   = "logs/perf.json";
+    std::string txlog_path;            // empty = no transaction log
+    TxMode      txlog_mode  = TxMode::CYCLE;
+    uint64_t    checkpoint  = 0;       // random-phase cycles between checkpoints, 0 = off
+    std::string ckpt_path   = "logs/checkpoint.ckpt";
+    bool        resume      = false;   // continue from ckpt_path if it exists
+    uint64_t    progress    = 0;       // seconds between progress lines, 0 = off
+    std::string vectors_path;          // vector file of the vectors test (vecstore.h)
+    uint64_t    vec_seed0   = 1;       // with +seeds the vectors test replays slice
+    uint64_t    vec_shards  = 1;       // (seed - vec_seed0) of vec_shards
+};
+
+static inline void dump_step(Bench& b) {
+    ++b.main_time;
+    b.trace->step(b.main_time);   // dump each half-cycle (inside the trace window)
+    // Low phase just evaluated: this is the state the next rising edge sees
+    if (b.flight && !b.top->clk) b.flight->sample(b.top.get(), b.main_time);
 }
 
-int main(int argc, char** argv) {
+// Scoreboard failure: fire the trace/flight-recorder triggers
+static void on_failure(Bench& b) {
+    b.trace->trigger(b.main_time);
+    if (b.flight) b.flight->trigger();
+}
 
-    // captures the argc/argv from main() and stores
-    // them inside Verilator’s global runtime context
-    Verilated::commandArgs(argc, argv);
-    Verilated::traceEverOn(true);
+// One clock cycle shared by every phase: drive on the low phase, snapshot the
+// pre-edge handshakes, then clock. Accept and transfer are both decided by
+// the values just before the rising edge, so the word to compare is the
+// pre-edge out_sum, not the one read after eval() on the posedge (which may
+// already be the next word).
+// Timed=true on the sampled cycles: each section's ticks go to its bucket.
+template <bool Timed>
+static inline void cycle_impl(Bench& b, bool in_valid, const Op& a, const Op& bv, const Op& exp,
+                              bool out_ready) {
+    Vadder_rv_simple* top = b.top.get();
+    uint64_t mark = Timed ? perf_ticks() : 0;
+    auto lap = [&](PerfBucket k) {
+        if constexpr (Timed) {
+            const uint64_t now = perf_ticks();
+            b.perf.ticks[k] += now - mark;
+            mark = now;
+        }
+    };
+
+    // ----- Low phase: drive inputs / readiness for the upcoming edge
+    top->clk       = 0;
+    top->in_valid  = in_valid;
+    AW::put(top->in_a, a);
+    AW::put(top->in_b, bv);
+    top->out_ready = out_ready;
+    top->eval();  lap(P_EVAL);
+    dump_step(b); lap(P_TRACE);
+
+    const bool     pre_send = top->out_valid && top->out_ready;
+    const Op       pre_sum  = AW::get(top->out_sum);
+    const uint64_t tag      = b.main_time / 2;
+
+    // If the DUT will accept this input at the edge, enqueue expectation
+    if (top->in_valid && top->in_ready) b.sb.expect(exp, tag);
+    if (b.dut_on) b.dut.cycle(tag, top->in_valid, top->in_ready, top->out_valid, top->out_ready);
+    lap(P_SB);
+
+    if (b.txlog) {
+        b.txlog->cycle(tag, (uint8_t)((top->in_valid  ? TX_IN_VALID  : 0) | (top->in_ready  ? TX_IN_READY  : 0)
+                                    | (top->out_valid ? TX_OUT_VALID : 0) | (top->out_ready ? TX_OUT_READY : 0)),
+                       AW::low64(a), AW::low64(bv), AW::low64(pre_sum));
+        lap(P_TRACE);
+    }
+
+    // ----- Rising edge: registers update (pop/push happen here)
+    top->clk = 1;
+    top->eval();  lap(P_EVAL);
+    dump_step(b); lap(P_TRACE);
+
+    if (pre_send && VL_UNLIKELY(!b.sb.check(pre_sum, tag))) {
+        if (b.txlog) b.txlog->mismatch(tag);
+        on_failure(b);
+    }
+    lap(P_SB);
+}
+
+static inline void cycle(Bench& b, bool in_valid, const Op& a, const Op& bv, const Op& exp,
+                         bool out_ready) {
+    if (VL_UNLIKELY(b.perf.sample())) cycle_impl<true>(b, in_valid, a, bv, exp, out_ready);
+    else                              cycle_impl<false>(b, in_valid, a, bv, exp, out_ready);
+}
+
+// Both slots empty (out_valid is out_buf_valid, in_ready is !spill_buf_valid)
+// and no sum expected: with in_valid low, a clock edge changes no register
+// whatever out_ready is, so idle cycles need not be evaluated.
+static inline bool dut_idle(const Bench& b) {
+    return !b.top->out_valid && b.top->in_ready && b.sb.empty();
+}
+
+// Advance over n idle cycles in one step. The model keeps its post-edge state
+// and the next cycle() drives it again. While tracing, the wave gets a single
+// dump at the end of the span (values are flat across it); the flight
+// recorder keeps only evaluated cycles. ready = cycles of the span with
+// out_ready drawn, for the DUT statistics.
+static void skip_idle(Bench& b, uint64_t n, uint64_t ready) {
+    if (b.dut_on) b.dut.idle(n, ready);
+    b.main_time += 2 * n;
+    b.skipped   += n;
+    b.trace->step(b.main_time);
+}
+
+static void usage() {
+    std::printf(
+"Usage: sim_adder_rv_simple [options]   (each option as +name=value or --name=value)\n"
+"\n"
+"Run mode\n"
+"  +seed=S              first seed (default 1)\n"
+"  +seeds=N             N independent model instances, seeds S..S+N-1 (default: one seed)\n"
+"  +jobs=J              worker threads/processes for +seeds (default: min(N, usable CPUs))\n"
+"  +fork=1              with +seeds: reset + directed warm-up once, then fork() a\n"
+"                       copy-on-write child per seed from that state (needs THREADS=1)\n"
+"\n"
+"Tests\n"
+"  +test=LIST           comma-separated test names or globs (default random); several\n"
+"                       tests run as a matrix of (test, seed) jobs like +seeds\n"
+"  +list                print the registered tests and exit\n"
+"  +vectors=FILE        vector file for +test=vectors: ADDV golden store or ADDB\n"
+"                       (bench/vecstore.h); with +seeds each seed takes a slice\n"
+"\n"
+"Stimulus\n"
+"  +cycles=N            test cycles per seed after the warm-up (default 2000)\n"
+"  +p_valid=P           percent of cycles with in_valid asserted (default 70)\n"
+"  +p_ready=P           percent of cycles with out_ready asserted (default 60)\n"
+"  +op_width=B          random operands use the low B bits (default: model width %u)\n"
+"  +idle_skip=0|1       jump over idle random-phase cycles without eval() (default 1)\n"
+"  +dut_stats=0|1       DUT latency / stall / occupancy histograms in perf.json (default 1)\n"
+"\n"
+"Coverage feedback (needs COVERAGE=1)\n"
+"  +cov_window=K        every K cycles (rounded up to 4096) read the live coverage and\n"
+"                       retarget traffic at uncovered points after a window without\n"
+"                       progress; reports the cycle of coverage closure (default 0 = off)\n"
+"  +cov_adapt=0         with +cov_window: measure closure only, keep the traffic as is\n"
+"  +cov_stop=1          with +cov_window: end the random phase once every point is hit\n"
+"\n"
+"Tracing\n"
+"  +trace=0|1           FST tracing (default: on for one seed, off for +seeds)\n"
+"  +trace_start=C       first traced cycle (default 0)\n"
+"  +trace_stop=C        stop tracing at cycle C (default: end of run)\n"
+"  +trace_on_error=1    do not trace until the first scoreboard mismatch\n"
+"  +trace_depth=N       hierarchy depth passed to trace() (default 5)\n"
+"  +trace_scope=H       only trace scope H and below (VerilatedFstC::dumpvars)\n"
+"  +trace_segment_mb=M  rotate the trace into <wave>_seg<N>.fst files of about M MB\n"
+"  +trace_keep=K        with +trace_segment_mb: newest segments kept on disk (default 2)\n"
+"  +flight=K            flight recorder: keep the last K cycles in memory and write\n"
+"                       them to the wave path only if the seed fails (implies +trace=0)\n"
+"  +flight_post=N       cycles still recorded after the first mismatch (default K/8)\n"
+"\n"
+"Outputs (with +seeds, _s<seed> is inserted before the extension; with several\n"
+"tests, _<test> before that)\n"
+"  +wave=PATH           waveform (default logs/wave.fst)\n"
+"  +cov=PATH            coverage data (default logs/coverage.dat)\n"
+"  +perf=PATH           run report (default logs/perf.json, one file per run)\n"
+"  +cov_merge=0|1       multi-job runs: merge the per-job coverage into +cov (default 1)\n"
+"  +cov_keep=0|1        keep the per-job coverage files after merging (default 1)\n"
+"\n"
+"Transaction log / replay\n"
+"  +txlog=PATH          binary log of the run (default off; +txlog=1 -> logs/txlog.txl)\n"
+"  +txlog_mode=M        cycle: one record per evaluated cycle (default, replayable)\n"
+"                       txn: one record per accepted transaction (data order only)\n"
+"  +replay=PATH         drive the model from a cycle log (e.g. a txlog_replay window)\n"
+"                       instead of the generator; single seed, traced by default\n"
+"\n"
+"Soak runs (single run of the random test)\n"
+"  +checkpoint=N        save model + harness state every N cycles (rounded up to 4096)\n"
+"                       to +checkpoint_path; needs a --savable model (SAVABLE=1)\n"
+"  +checkpoint_path=P   checkpoint file (default logs/checkpoint.ckpt, latest only)\n"
+"  +resume=1            continue from the checkpoint if there is one, else start fresh\n"
+"  +progress=S          print cycles/s, accepted and errors every S seconds (default 0 = off)\n"
+"\n"
+"  +help                this text\n", W);
+}
+
+// "logs/wave.fst" + "_s7" -> "logs/wave_s7.fst"
+static std::string tagged_path(const std::string& path, const std::string& tag) {
+    const std::size_t slash = path.find_last_of('/');
+    const std::size_t dot   = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + tag;
+    return path.substr(0, dot) + tag + path.substr(dot);
+}
+
+// One (test, seed) pair of a multi-job run. tag goes into its output paths:
+// "_<test>" when several tests run, "_s<seed>" with +seeds.
+struct Job {
+    unsigned    test;
+    uint64_t    seed;
+    std::string tag;
+};
 
-    // DUT + tracer
-    auto* top = new Vadder_rv_simple;
-    auto* tfp = new VerilatedFstC;
-    top->trace(tfp, /*depth*/ 5);
-    tfp->open("logs/wave.fst");
+// Per-job output paths for multi-job runs
+static RunOpts job_opts(const RunOpts& opts, const Job& job) {
+    RunOpts o = opts;
+    o.trace.path = tagged_path(opts.trace.path, job.tag);
+    o.cov_path   = tagged_path(opts.cov_path, job.tag);
+    if (!opts.txlog_path.empty()) o.txlog_path = tagged_path(opts.txlog_path, job.tag);
+    return o;
+}
+
+static RunOpts run_opts_from_args(const TbArgs& args, bool trace_default) {
+    RunOpts r;
+    r.cycles      = args.u64("cycles", r.cycles);
+    r.p_valid     = (unsigned)std::min<uint64_t>(100, args.u64("p_valid", r.p_valid));
+    r.p_ready     = (unsigned)std::min<uint64_t>(100, args.u64("p_ready", r.p_ready));
+    r.op_width    = (unsigned)std::min<uint64_t>(W, args.u64("op_width", r.op_width));
+    r.idle_skip   = args.u64("idle_skip", r.idle_skip) != 0;
+    r.dut_stats   = args.u64("dut_stats", r.dut_stats) != 0;
+    r.cov_window  = args.u64("cov_window", 0);
+    r.cov_adapt   = args.u64("cov_adapt", 1) != 0;
+    r.cov_stop    = args.u64("cov_stop", 0) != 0;
+    r.cov_merge   = args.u64("cov_merge", 1) != 0;
+    r.cov_keep    = args.u64("cov_keep", 1) != 0;
+#if !VM_COVERAGE
+    if (r.cov_window) {
+        std::fprintf(stderr, "[TB] +cov_window ignored: model built with COVERAGE=0\n");
+        r.cov_window = 0;
+    }
+#endif
+    r.cov_path    = args.str("cov", r.cov_path);
+    r.perf_path   = args.str("perf", r.perf_path);
+    r.txlog_path  = args.str("txlog", "");
+    if (r.txlog_path == "1") r.txlog_path = "logs/txlog.txl";
+    r.txlog_mode  = args.str("txlog_mode", "cycle") == "txn" ? TxMode::TXN : TxMode::CYCLE;
+    r.flight      = args.u64("flight", 0);
+    r.flight_post = args.u64("flight_post", r.flight / 8);
+    r.checkpoint  = args.u64("checkpoint", 0);
+    if (r.checkpoint) {
+        const uint64_t blk = StimulusBlock<W>::kBlock;
+        r.checkpoint = (r.checkpoint + blk - 1) / blk * blk;
+    }
+    r.ckpt_path   = args.str("checkpoint_path", r.ckpt_path);
+    r.resume      = args.u64("resume", 0) != 0;
+    r.progress    = args.u64("progress", 0);
+    r.vectors_path = args.str("vectors", "");
+    r.vec_seed0   = args.u64("seed", 1);
+    r.vec_shards  = std::max<uint64_t>(1, args.u64("seeds", 0));
+
+    TraceOpts& o = r.trace;
+    o.enable   = args.u64("trace", r.flight ? 0 : trace_default) != 0;
+    o.start    = args.u64("trace_start", o.start);
+    o.stop     = args.u64("trace_stop", o.stop);
+    o.on_error = args.u64("trace_on_error", 0) != 0;
+    o.depth    = (int)args.u64("trace_depth", o.depth);
+    o.scope    = args.str("trace_scope", o.scope);
+    o.path     = args.str("wave", o.path);
+    o.segment_bytes = args.u64("trace_segment_mb", 0) << 20;
+    o.keep     = (unsigned)std::max<uint64_t>(1, args.u64("trace_keep", o.keep));
+    if (r.flight && o.enable) {
+        // Both would write the wave path; live tracing wins over the recorder
+        std::fprintf(stderr, "[TB] +flight ignored: live tracing is enabled\n");
+        r.flight = 0;
+    }
+    return r;
+}
+
+// Model + tracer on a private context, handshake I/O at reset values.
+// The tracer stays detached until its window opens.
+static void bench_init(Bench& b, uint64_t seed, const RunOpts& opts) {
+    b.ctx = std::make_unique<VerilatedContext>();
+    b.ctx->traceEverOn(opts.trace.enable);
+    b.top = std::make_unique<Vadder_rv_simple>(b.ctx.get(), "TOP");
+    b.trace = std::make_unique<TraceCtl<Vadder_rv_simple>>(b.top.get(), opts.trace);
+    if (opts.flight) b.flight = std::make_unique<FlightRecorder<W>>(opts.flight, opts.flight_post);
+    b.seed = seed;
+
+    Vadder_rv_simple* top = b.top.get();
 
     // Clock/reset
     top->clk   = 0;
@@ -36,189 +466,996 @@ int main(int argc, char** argv) {
 
     // Handshake I/O init
     top->in_valid  = 0;
-    top->in_a      = 0;
-    top->in_b      = 0;
+    AW::put(top->in_a, Op{});
+    AW::put(top->in_b, Op{});
     top->out_ready = 0;
+}
 
-    // Scoreboard of expected sums (pushed on accept, popped on send)
-    std::queue<uint64_t> expq;
-
-    constexpr unsigned W = 32;
-    const uint64_t mask = (W == 64) ? ~0ull : ((1ull << W) - 1);
+// +txlog: open this seed's log (what the run has simulated so far is not in it)
+static void txlog_open(Bench& b, const RunOpts& opts) {
+    if (opts.txlog_path.empty()) return;
+    b.txlog = std::make_unique<TxLogWriter>();
+    if (!b.txlog->open(opts.txlog_path, opts.txlog_mode, W, b.seed)) {
+        std::fprintf(stderr, "[s%llu] cannot write %s\n", (unsigned long long)b.seed, opts.txlog_path.c_str());
+        b.txlog.reset();
+    }
+}
 
-    // PRNGs (deterministic)
-    std::mt19937_64 rng(1);
-    auto rand_bit = [&](int prob_percent) -> bool {
-        return (int)(rng() % 100) < prob_percent;
-    };
+// Print one phase's batch of scoreboard failures
+static void phase_report(Bench& b, const char* phase) {
+    char lbl[64];
+    std::snprintf(lbl, sizeof lbl, "[s%llu %s]", (unsigned long long)b.seed, phase);
+    b.sb.report(stderr, lbl);
+}
 
-    // ---- Reset for a few cycles
-    for (int i = 0; i < 4; ++i) {
-        top->clk = 0; top->eval(); dump_step(tfp);
-        top->clk = 1; top->eval(); dump_step(tfp);
+// Reset for a few cycles (kTxResetCycles: a replayed log starts after them)
+static void reset(Bench& bench) {
+    Vadder_rv_simple* top = bench.top.get();
+    for (uint64_t i = 0; i < kTxResetCycles; ++i) {
+        top->clk = 0; top->eval(); dump_step(bench);
+        top->clk = 1; top->eval(); dump_step(bench);
     }
     top->rst_n = 1;
+}
+
+// Source idle, sink ready, until everything accepted has come out (few cycles)
+static void drain(Bench& bench) {
+    for (int i = 0; i < 64 && (!bench.sb.empty() || bench.top->out_valid); ++i)
+        cycle(bench, false, {}, {}, {}, true);
+}
+
+// End of a test body: report its phase, drain, and count every expectation
+// still queued as a missing output
+static void end_of_test(Bench& bench, const char* phase) {
+    phase_report(bench, phase);
+    drain(bench);
+    bench.sb.finish(bench.main_time / 2);
+    if (bench.sb.errors()) on_failure(bench);
+    phase_report(bench, "DRN");
+}
+
+// Protocol check of a directed test (the scoreboard checks the data)
+static void test_check(Bench& b, bool ok, const char* what) {
+    if (VL_LIKELY(ok)) return;
+    if (b.check_errors++ < 10)
+        std::fprintf(stderr, "[s%llu] @%llu %s\n", (unsigned long long)b.seed,
+                     (unsigned long long)(b.main_time / 2), what);
+    on_failure(b);
+}
 
-    int errors = 0;
+// Reset + directed smoke + drain: the state every test starts from
+static void warmup(Bench& bench) {
+    reset(bench);
 
     // ---- Directed smoke: always-accept (no backpressure)
-    struct Vec { uint64_t a, b; };
+    struct Vec { Op a, b; };
+    const Op zero = AW::from_u64(0), one = AW::from_u64(1), max = AW::ones();
     const Vec dirv[] = {
-        {0,0}, {1,0}, {0,1}, {1,1}, {mask,1}, {mask,mask}
+        {zero,zero}, {one,zero}, {zero,one}, {one,one}, {max,one}, {max,max}
     };
 
-    for (auto v : dirv) {
-        // Drive inputs on "negedge" phase
-        top->clk = 0;
-        top->in_valid  = 1;
-        top->in_a      = v.a & mask;
-        top->in_b      = v.b & mask;
-        top->out_ready = 1;                 // consumer always ready here
-        top->eval(); dump_step(tfp);
-
-        // If DUT accepted, remember expected value
-        if (top->in_valid && top->in_ready) {
-            expq.push((v.a + v.b) & mask);
-        }
-
-        // "posedge": flops update, output may fire
-        top->clk = 1;
-        top->eval(); dump_step(tfp);
-
-        // If output fired, compare and pop
-        if (top->out_valid && top->out_ready) {
-            if (expq.empty()) {
-                std::fprintf(stderr, "[DIR] Unexpected output (empty expq)\n");
-                ++errors;
-            } else {
-                uint64_t exp = expq.front(); expq.pop();
-                uint64_t got = (uint64_t)top->out_sum;
-                if (got != exp) {
-                    std::fprintf(stderr, "[DIR] a=%llu b=%llu got=%llu exp=%llu\n",
-                        (unsigned long long)v.a, (unsigned long long)v.b,
-                        (unsigned long long)got, (unsigned long long)exp);
-                    ++errors;
-                }
-            }
-        }
+    for (const Vec& v : dirv) {
+        // consumer always ready here
+        cycle(bench, true, v.a, v.b, AW::add(v.a, v.b), true);
     }
+    phase_report(bench, "DIR");
 
     // Drain any remaining directed outputs (few cycles)
     // recall that the adder is buffered (it has storage), stopping stimulus
     // doesn’t mean the DUT’s output is immediately empty. During the directed tests
     // we may have pushed more items than we popped. So setting and
     // clocking a few cycles lets the DUT emit everything it already accepted.
-    for (int i = 0; i < 64 && (!expq.empty() || top->out_valid); ++i) {
-        // negedge phase
-        top->clk = 0;
-        top->in_valid = 0;
-        top->out_ready = 1;
-        top->eval();
-        dump_step(tfp);
-
-        // posedge phase
-        top->clk = 1;
-        top->eval();
-        dump_step(tfp);
-
-        if (top->out_valid && top->out_ready) {
-            if (expq.empty()) { std::fprintf(stderr, "[DIR] drain: empty expq\n"); ++errors; }
-            else {
-                uint64_t exp = expq.front(); expq.pop();
-                uint64_t got = (uint64_t)top->out_sum;
-                if (got != exp) {
-                    std::fprintf(stderr, "[DIR drain] got=%llu exp=%llu\n",
-                        (unsigned long long)got, (unsigned long long)exp);
-                    ++errors;
-                }
-            }
-        }
+    drain(bench);
+    phase_report(bench, "DIR drain");
+}
+
+// Coverage snapshot between stimulus blocks; retunes the following blocks when
+// the feedback switches profile. Returns true once every point is covered.
+static bool cov_step(Bench& b, CovFeedback& fb, StimulusBlock<W>& stim) {
+    const uint64_t now = b.main_time / 2;
+    if (fb.update(b.ctx.get(), now)) {
+        const CovProfile& p = fb.profile();
+        stim.set_probs(p.p_valid, p.p_ready);
+        stim.set_operand_top(p.carry);
+        std::printf("[s%llu] coverage %llu/%llu at cycle %llu, no progress: -> %s\n",
+                    (unsigned long long)b.seed, (unsigned long long)fb.covered(),
+                    (unsigned long long)fb.points(), (unsigned long long)now, p.name);
+    }
+    b.cov_points   = fb.points();
+    b.cov_covered  = fb.covered();
+    b.cov_closure  = fb.closure();
+    b.cov_last_new = fb.last_new();
+    return fb.closed();
+}
+
+// +checkpoint: model + harness state before random-phase cycle t (a block
+// boundary, so the generator resumes with its next fill())
+static void soak_save(Bench& b, const StimulusBlock<W>& stim, uint64_t t, const RunOpts& opts) {
+    const auto t0 = std::chrono::steady_clock::now();
+    auto st = std::make_unique<SoakState>();
+    st->seed          = b.seed;
+    st->p_valid       = opts.p_valid;
+    st->p_ready       = opts.p_ready;
+    st->op_width      = opts.op_width;
+    st->t             = t;
+    st->main_time     = b.main_time;
+    st->skipped       = b.skipped;
+    st->check_errors  = b.check_errors;
+    st->trace_segment = b.trace->segment();
+    st->sb            = b.sb;
+    st->dut           = b.dut;
+    std::memcpy(st->stim, (const void*)&stim, sizeof st->stim);
+    if (!ckpt_save(opts.ckpt_path, *b.top, *st)) {
+        std::fprintf(stderr, "[s%llu] checkpoint: cannot write %s\n", (unsigned long long)b.seed,
+                     opts.ckpt_path.c_str());
+        return;
+    }
+    std::printf("[s%llu] checkpoint at cycle %llu -> %s (%.3f s)\n", (unsigned long long)b.seed,
+                (unsigned long long)(b.main_time / 2), opts.ckpt_path.c_str(),
+                std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count());
+    std::fflush(stdout);
+}
+
+// +resume, before anything runs: the checkpoint must be readable and from a
+// run with the same seed and traffic. False with the reason printed.
+static bool soak_check(uint64_t seed, const RunOpts& opts) {
+    auto st = std::make_unique<SoakState>();
+    std::string err;
+    if (!ckpt_peek(opts.ckpt_path, *st, &err)) {
+        std::fprintf(stderr, "[TB] +resume: %s\n", err.c_str());
+        return false;
+    }
+    if (st->seed != seed || st->p_valid != opts.p_valid || st->p_ready != opts.p_ready ||
+        st->op_width != opts.op_width) {
+        std::fprintf(stderr, "[TB] +resume: %s is from +seed=%llu +p_valid=%u +p_ready=%u +op_width=%u\n",
+                     opts.ckpt_path.c_str(), (unsigned long long)st->seed, st->p_valid, st->p_ready,
+                     st->op_width);
+        return false;
+    }
+    return true;
+}
+
+// +resume: load the checkpoint into a freshly built bench instead of the
+// warm-up; random_phase() picks up the generator from bench.resume
+static bool soak_restore(Bench& b, const RunOpts& opts) {
+    auto st = std::make_unique<SoakState>();
+    std::string err;
+    if (!ckpt_load(opts.ckpt_path, *b.top, *st, &err)) {
+        std::fprintf(stderr, "[TB] +resume: %s\n", err.c_str());
+        return false;
+    }
+    b.main_time    = st->main_time;
+    b.skipped      = st->skipped;
+    b.check_errors = st->check_errors;
+    b.sb           = st->sb;
+    b.dut          = st->dut;
+    b.trace->set_segment(st->trace_segment + 1);   // keep the segment the job died in
+    std::printf("[s%llu] resumed from %s at cycle %llu\n", (unsigned long long)b.seed,
+                opts.ckpt_path.c_str(), (unsigned long long)(b.main_time / 2));
+    b.resume = std::move(st);
+    return true;
+}
+
+// Random streaming with backpressure + final drain for bench.seed
+static void random_phase(Bench& bench, const RunOpts& opts) {
+    SumScoreboard& sb = bench.sb;
+
+    // Random stimulus + expected sums, generated a block at a time (deterministic)
+    auto stim = std::make_unique<StimulusBlock<W>>(bench.seed, opts.op_width,
+                                                   opts.p_valid, opts.p_ready);
+    uint64_t first = 0;
+    if (bench.resume) {
+        std::memcpy((void*)stim.get(), bench.resume->stim, sizeof bench.resume->stim);
+        first = bench.resume->t;
+        bench.resume.reset();
+    }
+
+    // +progress: checked once per block, printed every opts.progress seconds
+    auto last_time = std::chrono::steady_clock::now();
+    uint64_t last_t = first;
+    auto progress = [&](uint64_t t) {
+        const auto now = std::chrono::steady_clock::now();
+        const double dt = std::chrono::duration<double>(now - last_time).count();
+        if (dt < (double)opts.progress) return;
+        const double rate = (t - last_t) / dt;
+        std::printf("[s%llu] PROGRESS %llu/%llu cycles (%.1f%%), %.0f cycles/s, %llu accepted, "
+                    "%llu errors, ETA %.0f s\n", (unsigned long long)bench.seed,
+                    (unsigned long long)t, (unsigned long long)opts.cycles, 100.0 * t / opts.cycles,
+                    rate, (unsigned long long)sb.pushed(),
+                    (unsigned long long)(sb.errors() + bench.check_errors),
+                    rate > 0 ? (opts.cycles - t) / rate : 0.0);
+        std::fflush(stdout);
+        last_time = now;
+        last_t    = t;
+    };
+
+    // Coverage feedback: snapshots fall on block boundaries
+    std::unique_ptr<CovFeedback> fb;
+    uint64_t window = 0;
+    if (opts.cov_window) {
+        const uint64_t blk = StimulusBlock<W>::kBlock;
+        window = (opts.cov_window + blk - 1) / blk * blk;
+        fb = std::make_unique<CovFeedback>(opts.cov_path + ".live", opts.p_valid, opts.p_ready,
+                                           opts.cov_adapt);
     }
 
     // ---- Randomized streaming with backpressure
-    const int cycles = 2000;
-    for (int t = 0; t < cycles; ++t) {
-        // Decide next inputs and consumer readiness
-        bool present = rand_bit(70);   // ~70% chance to assert in_valid
-        bool ready   = rand_bit(60);   // ~60% chance consumer ready
-
-        uint64_t a = rng() & mask;
-        uint64_t b = rng() & mask;
-
-        // ----- Low phase: drive inputs / readiness for the upcoming edge
-        top->clk       = 0;
-        top->in_valid  = present;
-        top->in_a      = a;
-        top->in_b      = b;
-        top->out_ready = ready;
-
-        top->eval(); dump_step(tfp);
-
-        // Snapshot *pre-edge* outputs; these decide the pop at this edge
-        const bool     pre_valid = top->out_valid;
-        const bool     pre_ready = top->out_ready;   // what the consumer will present at the edge
-        const uint64_t pre_sum   = (uint64_t)top->out_sum;
-
-        // If the DUT will accept this input at the edge, enqueue expectation
-        if (top->in_valid && top->in_ready) {
-            expq.push((a + b) & mask);
-        }
-
-        // ----- Rising edge: registers update (pop/push happen here)
-        top->clk = 1;
-        top->eval(); dump_step(tfp);
-
-        // Use the *pre-edge* snapshot to decide/verify the pop
-        // A transfer happens on the rising edge when out_valid && out_ready as
-        // they were just before that edge.
-        // So the value to compare is the pre-edge out_sum, not the one we read
-        // after eval() on the posedge (which may already be the next word).
-        if (pre_valid && pre_ready) {
-            if (expq.empty()) {
-                std::fprintf(stderr, "[RND %d] Unexpected output (empty expq)\n", t);
-                ++errors;
-            } else {
-                const uint64_t exp = expq.front(); expq.pop();
-                const uint64_t got = pre_sum;  // value that was actually transferred
-                if (got != exp) {
-                    std::fprintf(stderr, "[RND %d] got=%llu exp=%llu\n",
-                                t, (unsigned long long)got, (unsigned long long)exp);
-                    ++errors;
-                }
-            }
+    for (uint64_t t = first; t < opts.cycles; ++t) {
+        const std::size_t i = (std::size_t)(t % StimulusBlock<W>::kBlock);
+        if (i == 0) {
+            if (opts.checkpoint && t > first && t % opts.checkpoint == 0) soak_save(bench, *stim, t, opts);
+            if (opts.progress) progress(t);
+            const uint64_t t0 = perf_ticks();
+            if (fb && t % window == 0 && cov_step(bench, *fb, *stim) && opts.cov_stop)
+                break;
+            stim->fill();
+            bench.perf.ticks[P_STIM] += perf_ticks() - t0;
         }
 
-        if (VL_UNLIKELY(Verilated::gotFinish())) break;
-    }
+        // Fast-forward to the next drawn in_valid (at most to the block end)
+        if (opts.idle_skip && !stim->present(i) && dut_idle(bench)) {
+            const uint64_t n = std::min<uint64_t>(stim->next_present(i) - i, opts.cycles - t);
+            skip_idle(bench, n, stim->ready_count(i, (std::size_t)n));
+            t += n - 1;
+            continue;
+        }
+
+        // ~p_valid% chance to assert in_valid, ~p_ready% chance consumer ready
+        cycle(bench, stim->present(i), stim->a(i), stim->b(i), stim->sum(i), stim->ready(i));
 
+        if (VL_UNLIKELY(bench.ctx->gotFinish())) break;
+    }
+    phase_report(bench, "RND");
 
     // Final drain (keep source idle, let sink pull)
-    for (int i = 0; i < 64 && (!expq.empty() || top->out_valid); ++i) {
-        top->clk = 0; top->in_valid = 0; top->out_ready = 1; top->eval(); dump_step(tfp);
-        top->clk = 1; top->eval(); dump_step(tfp);
-        if (top->out_valid && top->out_ready) {
-            if (expq.empty()) { std::fprintf(stderr, "[DRN] empty expq\n"); ++errors; }
-            else {
-                uint64_t exp = expq.front(); expq.pop();
-                uint64_t got = (uint64_t)top->out_sum;
-                if (got != exp) {
-                    std::fprintf(stderr, "[DRN] got=%llu exp=%llu\n",
-                        (unsigned long long)got, (unsigned long long)exp);
-                    ++errors;
-                }
+    drain(bench);
+    if (fb) cov_step(bench, *fb, *stim);
+    sb.finish(bench.main_time / 2);   // anything still expected never came out
+    if (sb.errors()) on_failure(bench);
+    phase_report(bench, "DRN");
+
+    // A clean finish retires the checkpoint, so +resume on the same command
+    // line starts a fresh run instead of replaying the tail of this one; a
+    // failing run keeps it to rerun the failing leg
+    if ((opts.checkpoint || opts.resume) && !bench.ctx->gotFinish() && ckpt_exists(opts.ckpt_path)) {
+        if (sb.errors() + bench.check_errors)
+            std::printf("[s%llu] checkpoint kept: %s\n", (unsigned long long)bench.seed,
+                        opts.ckpt_path.c_str());
+        else if (std::remove(opts.ckpt_path.c_str()) == 0)
+            std::printf("[s%llu] run complete, checkpoint %s removed\n", (unsigned long long)bench.seed,
+                        opts.ckpt_path.c_str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Test cases. Each body starts from the post-warm-up state, drives at most
+// opts.cycles cycles and ends with end_of_test(); the runner wraps it with
+// the DUT statistics and the result.
+
+using TestFn = void (*)(Bench&, const RunOpts&);
+using Tests  = TestRegistry<TestFn>;
+
+#define TB_TEST(name, doc)                                                 \
+    static void tb_test_##name(Bench& bench, const RunOpts& opts);        \
+    static const Tests::Add tb_add_##name(#name, doc, tb_test_##name);    \
+    static void tb_test_##name(Bench& bench, const RunOpts& opts)
+
+TB_TEST(smoke, "reset, directed vectors and drain only") {
+    (void)bench; (void)opts;
+}
+
+TB_TEST(random, "random valid/ready traffic at +p_valid/+p_ready (the default)") {
+    random_phase(bench, opts);
+}
+
+// With the sink always ready the output buffer frees every cycle, so a
+// 2-entry elastic buffer must take one input per cycle however long the burst
+TB_TEST(burst, "bursts of 1..64 back-to-back inputs, sink always ready: no input stall allowed") {
+    auto stim = std::make_unique<StimulusBlock<W>>(bench.seed, opts.op_width, 100, 100);
+    std::mt19937_64 rng(bench.seed);
+    uint64_t left = 0;
+    bool     on   = false;
+    for (uint64_t t = 0; t < opts.cycles; ++t) {
+        const std::size_t i = (std::size_t)(t % StimulusBlock<W>::kBlock);
+        if (i == 0) stim->fill();
+        if (left == 0) { on = !on; left = 1 + rng() % 64; }
+        --left;
+        if (on) test_check(bench, bench.top->in_ready, "in_ready low during a burst, sink ready");
+        cycle(bench, on, stim->a(i), stim->b(i), stim->sum(i), true);
+    }
+    end_of_test(bench, "BST");
+}
+
+// Full offered load against a stalled sink: from empty, the buffer takes
+// exactly two inputs (out + spill), then holds in_ready low until the sink
+// resumes, after which it is back to one transfer per cycle
+TB_TEST(stall, "sink stalls 3..64 cycles under full load: exactly 2 accepted per stall") {
+    auto stim = std::make_unique<StimulusBlock<W>>(bench.seed, opts.op_width, 100, 100);
+    std::mt19937_64 rng(bench.seed);
+    std::size_t i = 0;
+    stim->fill();
+    auto drive = [&](bool valid, bool ready) {
+        if (i == StimulusBlock<W>::kBlock) { stim->fill(); i = 0; }
+        cycle(bench, valid, stim->a(i), stim->b(i), stim->sum(i), ready);
+        ++i;
+    };
+    for (uint64_t t = 0; t < opts.cycles;) {
+        drain(bench);
+        const uint64_t stall = 3 + rng() % 62, run = 1 + rng() % 16;
+        uint64_t took = 0;
+        for (uint64_t k = 0; k < stall; ++k) {
+            took += bench.top->in_ready;   // register: the value the next edge sees
+            drive(true, false);
+        }
+        test_check(bench, took == 2, "stalled sink: elastic buffer did not take exactly 2 inputs");
+        test_check(bench, !bench.top->in_ready && bench.top->out_valid, "stalled sink: buffer not full");
+        for (uint64_t k = 0; k < run; ++k) drive(true, true);
+        t += stall + run;
+    }
+    end_of_test(bench, "STL");
+}
+
+// Operands from the carry corners, so every add carries into and/or out of
+// the top bit; valid/ready are still random at +p_valid/+p_ready
+TB_TEST(max_operands, "operands from {0, 1, max-1, max, top bit, max^top bit}, random valid/ready") {
+    const Op max = AW::ones(), top = AW::bit(W - 1);
+    const Op corner[] = {AW::from_u64(0), AW::from_u64(1), AW::add(max, max), max, top, AW::add(max, top)};
+    constexpr uint64_t kCorners = sizeof corner / sizeof corner[0];
+    auto stim = std::make_unique<StimulusBlock<W>>(bench.seed, W, opts.p_valid, opts.p_ready);
+    for (uint64_t t = 0; t < opts.cycles; ++t) {
+        const std::size_t i = (std::size_t)(t % StimulusBlock<W>::kBlock);
+        if (i == 0) stim->fill();
+        const Op& a = corner[AW::low64(stim->a(i)) % kCorners];
+        const Op& b = corner[AW::low64(stim->b(i)) % kCorners];
+        cycle(bench, stim->present(i), a, b, AW::add(a, b), stim->ready(i));
+    }
+    end_of_test(bench, "MAX");
+}
+
+// The shared vectors offered in order: every vector of the +vectors file (an
+// ADDV golden store or an ADDB input file, mapped through vecstore.h), or
+// without one +cycles pairs of cosim_tb's own LCG stream for +seed, i.e. what
+// `cosim_tb --n=N --seed=S` sends (32-bit values, masked to W). in_valid and
+// out_ready follow the store's schedules where it has them; otherwise
+// in_valid stays high until the last vector and out_ready is +p_ready. The
+// expected sum is the store's golden column when it has one. With +seeds=K
+// each seed replays its own 1/K slice of the file, all from one copy in the
+// page cache.
+TB_TEST(vectors, "shared vectors in order: +vectors=FILE (ADDV store or ADDB) or cosim_tb's LCG stream") {
+    std::unique_ptr<VecStore> st;
+    uint64_t i = 0, end = opts.cycles;
+    if (!opts.vectors_path.empty()) {
+        st = std::make_unique<VecStore>();
+        std::string err;
+        if (!st->open(opts.vectors_path, &err)) {
+            std::fprintf(stderr, "[TB] +vectors: %s\n", err.c_str());
+            test_check(bench, false, "+vectors file unreadable");
+            return;
+        }
+        const uint64_t k = bench.seed - opts.vec_seed0, n = opts.vec_shards;
+        i   = st->count() * k / n;
+        end = st->count() * (k + 1) / n;
+        st->will_need(i, end - i);
+    }
+    uint32_t lcg = (uint32_t)bench.seed;   // cosim_tb.cpp Lcg
+    Op a{}, b{}, sum{};
+    auto load = [&]() {
+        if (i == end) return false;
+        if (st) {
+            a = AW::from_u64(st->a(i)), b = AW::from_u64(st->b(i));
+            sum = st->has_sum() ? AW::from_u64(st->sum(i)) : AW::add(a, b);
+        } else {
+            a = AW::from_u64(lcg = lcg * 1664525u + 1013904223u);
+            b = AW::from_u64(lcg = lcg * 1664525u + 1013904223u);
+            sum = AW::add(a, b);
+        }
+        ++i;
+        return true;
+    };
+
+    std::mt19937_64 rng(bench.seed);
+    const bool sched_valid = st && st->has_valid(), sched_ready = st && st->has_ready();
+    uint64_t t = 0, stuck = 0;
+    bool have = load();
+    while (have) {
+        const bool valid = !sched_valid || st->valid(t);
+        const bool ready = sched_ready ? st->ready(t) : opts.p_ready >= 100 || rng() % 100 < opts.p_ready;
+        const bool take  = valid && bench.top->in_ready;   // register: the value the next edge sees
+        cycle(bench, valid, a, b, sum, ready);
+        ++t;
+        if (!take) {
+            if (valid && ++stuck == 1000) { test_check(bench, false, "in_ready low for 1000 cycles"); break; }
+            continue;
+        }
+        stuck = 0;
+        have = load();
+    }
+    end_of_test(bench, "VEC");
+}
+
+// Close tracing, dump the flight recorder on failure, write coverage and
+// collect the result. first_cycle = cycles this process did not simulate.
+static RunResult finish(Bench& bench, const RunOpts& opts,
+                        std::chrono::steady_clock::time_point t0, uint64_t first_cycle) {
+    const TraceOpts& topts = opts.trace;
+    const SumScoreboard& sb = bench.sb;
+    const unsigned long long sd = (unsigned long long)bench.seed;
+
+    bench.trace->close();
+    RunResult res;
+    if (bench.txlog) {
+        res.txlog_records = bench.txlog->records();
+        res.txlog_bytes   = bench.txlog->bytes();
+        if (!bench.txlog->close())
+            std::fprintf(stderr, "[s%llu] txlog: write error on %s\n", sd, opts.txlog_path.c_str());
+        else
+            std::printf("[s%llu] txlog: %llu records, %llu bytes -> %s\n", sd,
+                        (unsigned long long)res.txlog_records, (unsigned long long)res.txlog_bytes,
+                        opts.txlog_path.c_str());
+        bench.txlog.reset();
+    }
+    if (bench.flight && (sb.errors() + bench.check_errors)) {
+        if (bench.flight->write_fst(topts.path))
+            std::fprintf(stderr, "[s%llu] flight recorder: last %llu cycles -> %s\n", sd,
+                         (unsigned long long)bench.flight->size(), topts.path.c_str());
+        else
+            std::fprintf(stderr, "[s%llu] flight recorder: cannot write %s (needs TRACE=1)\n",
+                         sd, topts.path.c_str());
+    }
+    bench.top->final();
+#if VM_COVERAGE
+    bench.ctx->coveragep()->write(opts.cov_path.c_str());
+#endif
+
+    res.seed     = bench.seed;
+    res.errors   = (int)(sb.errors() + bench.check_errors);
+    res.cycles   = bench.main_time / 2 - first_cycle;
+    res.accepted = sb.pushed();
+    res.emitted  = sb.checked();
+    res.skipped  = bench.skipped;
+    res.cov_points   = bench.cov_points;
+    res.cov_covered  = bench.cov_covered;
+    res.cov_closure  = bench.cov_closure;
+    res.cov_last_new = bench.cov_last_new;
+    res.p_valid  = opts.p_valid;
+    res.p_ready  = opts.p_ready;
+    res.dut      = bench.dut;
+    res.perf     = bench.perf;
+    res.secs     = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return res;
+}
+
+// Registered test body with the DUT statistics around it
+static void run_test(Bench& bench, unsigned test, const RunOpts& opts) {
+    bench.dut_on = opts.dut_stats;
+    Tests::at(test).fn(bench, opts);
+    bench.dut.finish();
+    bench.dut_on = false;
+}
+
+static RunResult run_seed(unsigned test, uint64_t seed, const RunOpts& opts) {
+    const auto t0 = std::chrono::steady_clock::now();
+
+    Bench bench;
+    bench_init(bench, seed, opts);
+    txlog_open(bench, opts);
+
+    // +resume with a checkpoint on disk replaces the warm-up; cycles and
+    // rates then cover this leg of the run only
+    uint64_t first_cycle = 0;
+    if (opts.resume && ckpt_exists(opts.ckpt_path)) {
+        if (!soak_restore(bench, opts)) {
+            RunResult r;
+            r.seed = seed;
+            r.test = test;
+            r.errors = 1;
+            return r;
+        }
+        first_cycle = bench.main_time / 2;
+    }
+
+    bench.perf.start();
+    if (!bench.resume) warmup(bench);
+    run_test(bench, test, opts);
+    bench.perf.stop();
+
+    RunResult r = finish(bench, opts, t0, first_cycle);
+    r.test = test;
+    return r;
+}
+
+static void json_time_split(std::FILE* f, const PerfCounters& p) {
+    std::fprintf(f, "{\"eval\": %.6f, \"trace\": %.6f, \"stimulus\": %.6f, \"scoreboard\": %.6f}",
+                 p.secs(P_EVAL), p.secs(P_TRACE), p.secs(P_STIM), p.secs(P_SB));
+}
+
+// Registry name of a run's test (replay runs have none)
+static const char* test_name(const RunResult& r) {
+    return r.test < Tests::all().size() ? Tests::at(r.test).name : "replay";
+}
+
+// Run report: totals over all runs plus one entry per (test, seed) run
+static void write_perf_json(const char* path, const std::vector<RunResult>& runs,
+                            unsigned jobs, double wall_s) {
+    std::FILE* f = std::fopen(path, "w");
+    if (!f) { std::fprintf(stderr, "[TB] cannot write %s\n", path); return; }
+
+    uint64_t cycles = 0, acc = 0, emi = 0, skip = 0;
+    double t[P_COUNT] = {};
+    DutStats dut;
+    for (const RunResult& r : runs) {
+        cycles += r.cycles; acc += r.accepted; emi += r.emitted; skip += r.skipped;
+        dut.merge(r.dut);
+        for (unsigned k = 0; k < P_COUNT; ++k) t[k] += r.perf.secs((PerfBucket)k);
+    }
+    auto rate = [](double n, double s) { return s > 0 ? n / s : 0.0; };
+
+    std::fprintf(f, "{\n");
+#ifdef VERILATOR_VERSION
+    std::fprintf(f, "  \"verilator\": \"%s\",\n", VERILATOR_VERSION);
+#endif
+    std::fprintf(f, "  \"width\": %u,\n", W);
+    std::fprintf(f, "  \"seeds\": %zu,\n  \"jobs\": %u,\n  \"wall_s\": %.6f,\n", runs.size(), jobs, wall_s);
+    std::fprintf(f, "  \"peak_rss_kb\": %ld,\n", perf_peak_rss_kb());
+    std::fprintf(f, "  \"sample_period\": %llu,\n", (unsigned long long)PerfCounters::kSamplePeriod);
+    std::fprintf(f, "  \"total\": {\"cycles\": %llu, \"cycles_per_s\": %.1f, \"idle_skipped\": %llu, "
+                    "\"accepted\": %llu, \"accepted_per_s\": %.1f, "
+                    "\"emitted\": %llu, \"emitted_per_s\": %.1f, "
+                    "\"cpu_time_s\": {\"eval\": %.6f, \"trace\": %.6f, \"stimulus\": %.6f, \"scoreboard\": %.6f}",
+                 (unsigned long long)cycles, rate(cycles, wall_s), (unsigned long long)skip,
+                 (unsigned long long)acc, rate(acc, wall_s),
+                 (unsigned long long)emi, rate(emi, wall_s),
+                 t[P_EVAL], t[P_TRACE], t[P_STIM], t[P_SB]);
+    if (dut.cycles && !runs.empty()) {
+        std::fprintf(f, ", \"dut\": ");
+        dut.json(f, runs[0].p_valid, runs[0].p_ready, /*timeline*/ false);
+    }
+    std::fprintf(f, "},\n");
+    std::fprintf(f, "  \"runs\": [\n");
+    for (std::size_t i = 0; i < runs.size(); ++i) {
+        const RunResult& r = runs[i];
+        const double w = r.perf.wall_s();
+        std::fprintf(f, "    {\"test\": \"%s\", \"seed\": %llu, \"errors\": %d, \"cycles\": %llu, \"idle_skipped\": %llu, \"wall_s\": %.6f, "
+                        "\"cycles_per_s\": %.1f, \"accepted_per_s\": %.1f, \"emitted_per_s\": %.1f, "
+                        "\"tsc_hz\": %.0f, \"time_s\": ",
+                     test_name(r), (unsigned long long)r.seed, r.errors, (unsigned long long)r.cycles,
+                     (unsigned long long)r.skipped, w,
+                     rate(r.cycles, w), rate(r.accepted, w), rate(r.emitted, w), r.perf.tick_hz());
+        json_time_split(f, r.perf);
+        if (r.cov_points) {
+            std::fprintf(f, ", \"coverage\": {\"points\": %llu, \"covered\": %llu, \"closure_cycle\": ",
+                         (unsigned long long)r.cov_points, (unsigned long long)r.cov_covered);
+            if (r.cov_closure == CovFeedback::kNone) std::fprintf(f, "null");
+            else std::fprintf(f, "%llu", (unsigned long long)r.cov_closure);
+            std::fprintf(f, ", \"last_new_cycle\": %llu}", (unsigned long long)r.cov_last_new);
+        }
+        if (r.dut.cycles) {
+            std::fprintf(f, ", \"dut\": ");
+            r.dut.json(f, r.p_valid, r.p_ready, /*timeline*/ true);
+        }
+        std::fprintf(f, "}%s\n", i + 1 < runs.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+    std::fclose(f);
+}
+
+// CPUs this process may run on (honours taskset/numactl)
+static std::vector<int> usable_cpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int c = 0; c < CPU_SETSIZE; ++c)
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    }
+    if (cpus.empty()) cpus.push_back(0);
+    return cpus;
+}
+
+static void pin_to_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+// " C/P points, closed at cycle N" for runs with +cov_window
+static void cov_summary(const RunResult& r) {
+    if (!r.cov_points) return;
+    std::printf(" %llu/%llu points", (unsigned long long)r.cov_covered,
+                (unsigned long long)r.cov_points);
+    if (r.cov_closure != CovFeedback::kNone)
+        std::printf(", closed at cycle %llu", (unsigned long long)r.cov_closure);
+    else
+        std::printf(", not closed (last new point at cycle %llu)", (unsigned long long)r.cov_last_new);
+}
+
+// Per-run report in job order, then the total. Runs are labelled by seed,
+// or by test and seed once more than one test is in the matrix.
+static int summarize(const char* mode, const std::vector<RunResult>& results,
+                     unsigned jobs, double secs, const std::string& perf_path) {
+    const uint64_t nseeds = results.size();
+    bool multi = false;
+    for (const RunResult& r : results) multi |= r.test != results[0].test;
+    uint64_t failed = 0, cycles = 0;
+    for (const RunResult& r : results) {
+        if (multi) std::printf("[%s s%llu]", test_name(r), (unsigned long long)r.seed);
+        else       std::printf("[seed %llu]", (unsigned long long)r.seed);
+        std::printf(" %s cycles=%llu mismatches=%d (%.3f s)", r.errors ? "FAIL" : "PASS",
+                    (unsigned long long)r.cycles, r.errors, r.secs);
+        cov_summary(r);
+        std::printf("\n");
+        failed += (r.errors != 0);
+        cycles += r.cycles;
+    }
+    std::printf("%s: %llu/%llu %s passed, %u workers, %.3f s, %.0f cycles/s\n", mode,
+                (unsigned long long)(nseeds - failed), (unsigned long long)nseeds, multi ? "runs" : "seeds",
+                jobs, secs, secs > 0 ? cycles / secs : 0.0);
+    DutStats dut;
+    for (const RunResult& r : results) dut.merge(r.dut);
+    if (dut.cycles) {
+        std::printf("DUT: ");
+        dut.print(stdout);
+        std::printf("\n");
+    }
+    write_perf_json(perf_path.c_str(), results, jobs, secs);
+
+    if (failed) {
+        std::fprintf(stderr, "TEST FAIL: %llu of %llu %s failed\n",
+                     (unsigned long long)failed, (unsigned long long)nseeds, multi ? "runs" : "seeds");
+        return 1;
+    }
+    std::printf("TEST PASS\n");
+    return 0;
+}
+
+// Multi-job runs: fold the per-job coverage shards into the untagged
+// coverage path with the run's worker count
+static void merge_job_coverage(const std::vector<Job>& matrix, unsigned jobs, const RunOpts& opts) {
+#if VM_COVERAGE
+    if (!opts.cov_merge) return;
+    std::vector<std::string> shards;
+    shards.reserve(matrix.size());
+    for (const Job& j : matrix) shards.push_back(tagged_path(opts.cov_path, j.tag));
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::string> failed;
+    CovDb db;
+    const bool ok = cov_merge_files(shards, opts.cov_path, jobs, &failed, &db);
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    for (const std::string& f : failed) std::fprintf(stderr, "[TB] coverage shard %s missing\n", f.c_str());
+    if (!ok) {
+        std::fprintf(stderr, "[TB] coverage merge into %s failed\n", opts.cov_path.c_str());
+        return;
+    }
+    std::printf("COVERAGE: merged %llu shards, %zu points (%zu covered) -> %s (%.3f s)\n",
+                (unsigned long long)db.files(), db.points(), db.covered(), opts.cov_path.c_str(), secs);
+    if (!opts.cov_keep)
+        for (const std::string& s : shards) std::remove(s.c_str());
+#else
+    (void)matrix; (void)jobs; (void)opts;
+#endif
+}
+
+static unsigned clamp_jobs(unsigned jobs, uint64_t nseeds, std::size_t ncpus) {
+    if (jobs == 0) jobs = (unsigned)std::min<uint64_t>(nseeds, ncpus);
+    return (unsigned)std::max<uint64_t>(1, std::min<uint64_t>(jobs, nseeds));
+}
+
+// The (test, seed) jobs of a run, test-major
+static std::vector<Job> job_matrix(const std::vector<std::size_t>& tests, uint64_t seed0, uint64_t nseeds) {
+    std::vector<Job> matrix;
+    for (std::size_t t : tests) {
+        const std::string name = tests.size() > 1 ? std::string("_") + Tests::at(t).name : std::string();
+        if (nseeds == 0) matrix.push_back(Job{(unsigned)t, seed0, name});
+        for (uint64_t i = 0; i < nseeds; ++i)
+            matrix.push_back(Job{(unsigned)t, seed0 + i, name + "_s" + std::to_string(seed0 + i)});
+    }
+    return matrix;
+}
+
+// Job-sharded regression: workers pull (test, seed) jobs from a shared counter
+static int run_regress(const std::vector<Job>& matrix, unsigned jobs, const RunOpts& opts) {
+    const uint64_t njobs = matrix.size();
+    const std::vector<int> cpus = usable_cpus();
+    jobs = clamp_jobs(jobs, njobs, cpus.size());
+
+    std::vector<RunResult> results(njobs);
+    std::atomic<uint64_t> next{0};
+    const auto t0 = std::chrono::steady_clock::now();
+
+    auto worker = [&](unsigned wid) {
+        pin_to_cpu(cpus[wid % cpus.size()]);
+        for (uint64_t i = next.fetch_add(1); i < njobs; i = next.fetch_add(1)) {
+            const Job& j = matrix[i];
+            results[i] = run_seed(j.test, j.seed, job_opts(opts, j));
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(jobs);
+    for (unsigned w = 0; w < jobs; ++w) pool.emplace_back(worker, w);
+    for (auto& th : pool) th.join();
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    merge_job_coverage(matrix, jobs, opts);
+    return summarize("REGRESS", results, jobs, secs, opts.perf_path);
+}
+
+// Child side of the fork fan-out: continue the inherited post-warm-up model
+// with this job's test. Results go back to the parent through a pipe.
+static RunResult fork_child(Bench& bench, const Job& job, const RunOpts& opts, uint64_t warm_cycles) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const RunOpts o = job_opts(opts, job);
+    bench.seed  = job.seed;
+    bench.trace = std::make_unique<TraceCtl<Vadder_rv_simple>>(bench.top.get(), o.trace);
+    bench.perf  = PerfCounters{};
+    txlog_open(bench, o);
+
+    bench.perf.start();
+    run_test(bench, job.test, o);
+    bench.perf.stop();
+    RunResult r = finish(bench, o, t0, warm_cycles);
+    r.test = job.test;
+    return r;
+}
+
+// Snapshot fan-out: build the model, reset and run the directed warm-up once,
+// then fork() one copy-on-write child per job (at most `jobs` at a time).
+// fork() only duplicates the calling thread, so this needs a single-threaded
+// model (THREADS=1) and no tracer open before the fork; the parent never
+// traces, children open their own wave files.
+static int run_fork(const std::vector<Job>& matrix, unsigned jobs, const RunOpts& opts) {
+    const uint64_t nseeds = matrix.size();
+    const std::vector<int> cpus = usable_cpus();
+    jobs = clamp_jobs(jobs, nseeds, cpus.size());
+    const auto t0 = std::chrono::steady_clock::now();
+
+    Bench bench;
+    bench_init(bench, matrix[0].seed, opts);
+    if (bench.top->threads() > 1) {
+        std::fprintf(stderr, "[TB] +fork needs a single-threaded model (build with THREADS=1), "
+                             "this one uses %u threads\n", bench.top->threads());
+        return 2;
+    }
+    TraceOpts off = opts.trace;
+    off.enable = false;
+    bench.trace = std::make_unique<TraceCtl<Vadder_rv_simple>>(bench.top.get(), off);
+
+    warmup(bench);
+    const uint64_t warm_cycles = bench.main_time / 2;
+    std::printf("FORK: warm-up done after %llu cycles, fanning out %llu jobs\n",
+                (unsigned long long)warm_cycles, (unsigned long long)nseeds);
+
+    static_assert(std::is_trivially_copyable<RunResult>::value, "RunResult goes through a pipe");
+    static_assert(sizeof(RunResult) <= PIPE_BUF, "RunResult must fit one atomic pipe write");
+    struct Child { pid_t pid; int fd; uint64_t idx; unsigned slot; };
+    std::vector<Child> live;
+    std::vector<bool>  slot_busy(jobs, false);
+    std::vector<RunResult> results(nseeds);
+    uint64_t next = 0;
+
+    while (next < nseeds || !live.empty()) {
+        // Keep `jobs` children running
+        while (live.size() < jobs && next < nseeds) {
+            int fds[2];
+            if (pipe(fds) != 0) { std::perror("[TB] pipe"); return 2; }
+            const unsigned slot = (unsigned)(std::find(slot_busy.begin(), slot_busy.end(), false)
+                                             - slot_busy.begin());
+            const uint64_t idx = next++;
+
+            std::fflush(stdout);
+            std::fflush(stderr);
+            const pid_t pid = fork();
+            if (pid < 0) { std::perror("[TB] fork"); return 2; }
+            if (pid == 0) {
+                close(fds[0]);
+                pin_to_cpu(cpus[slot % cpus.size()]);
+                const RunResult r = fork_child(bench, matrix[idx], opts, warm_cycles);
+                const ssize_t n = write(fds[1], &r, sizeof r);
+                std::fflush(stdout);
+                std::fflush(stderr);
+                _exit(n == (ssize_t)sizeof r ? 0 : 3);
             }
+            close(fds[1]);
+            slot_busy[slot] = true;
+            live.push_back(Child{pid, fds[0], idx, slot});
         }
+
+        // Reap one child and collect its result
+        int status = 0;
+        const pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) { std::perror("[TB] waitpid"); return 2; }
+        auto it = std::find_if(live.begin(), live.end(), [&](const Child& c) { return c.pid == pid; });
+        if (it == live.end()) continue;
+
+        RunResult& r = results[it->idx];
+        const ssize_t n = read(it->fd, &r, sizeof r);
+        if (n != (ssize_t)sizeof r || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            r = RunResult{};
+            r.seed   = matrix[it->idx].seed;
+            r.test   = matrix[it->idx].test;
+            r.errors = 1;
+            std::fprintf(stderr, "[s%llu] child exited abnormally (status 0x%x)\n",
+                         (unsigned long long)r.seed, (unsigned)status);
+        }
+        close(it->fd);
+        slot_busy[it->slot] = false;
+        live.erase(it);
+    }
+
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    merge_job_coverage(matrix, jobs, opts);
+    return summarize("FORK", results, jobs, secs, opts.perf_path);
+}
+
+// +replay: drive the model from a cycle-mode transaction log instead of the
+// generator. Records keep their cycle numbers, so +trace_start/+trace_stop
+// and the wave's time axis match the original run; spans without records
+// were idle there and are skipped here. The DUT's pre-edge handshakes and
+// handed-over sums are compared with the log as well as scored: a divergence
+// means the log came from other RTL, or a window was cut without its
+// in-flight items.
+static int run_replay(const std::string& path, const RunOpts& opts) {
+    TxLogReader log;
+    if (!log.open(path)) { std::fprintf(stderr, "[TB] +replay: %s\n", log.error().c_str()); return 2; }
+    if (log.mode() != TxMode::CYCLE) {
+        std::fprintf(stderr, "[TB] +replay: %s is a txn log (no timing); record with +txlog_mode=cycle\n",
+                     path.c_str());
+        return 2;
+    }
+    if (log.width() != W) {
+        std::fprintf(stderr, "[TB] +replay: %s has %u-bit operands, this model %u\n", path.c_str(), log.width(), W);
+        return 2;
     }
 
-    // Close tracing and write coverage
-    tfp->close();
-    VerilatedCov::write("logs/coverage.dat");
+    const auto t0 = std::chrono::steady_clock::now();
+    Bench bench;
+    bench_init(bench, log.seed(), opts);
+    Vadder_rv_simple* top = bench.top.get();
 
-    delete tfp;
-    delete top;
+    bench.perf.start();
+    reset(bench);
+    uint64_t nrec = 0, diverged = 0, first = 0, last = 0;
+    TxRec r;
+    while (log.next(r)) {
+        const uint64_t now = bench.main_time / 2;
+        if (r.cycle < now) {
+            std::fprintf(stderr, "[TB] +replay: record for cycle %llu, model is at cycle %llu\n",
+                         (unsigned long long)r.cycle, (unsigned long long)now);
+            ++diverged;
+            break;
+        }
+        if (r.cycle > now) {
+            if (dut_idle(bench)) skip_idle(bench, r.cycle - now, 0);
+            else while (bench.main_time / 2 < r.cycle) cycle(bench, false, {}, {}, {}, false);
+        }
 
-    if (errors) {
-        std::fprintf(stderr, "TEST FAIL: %d mismatches\n", errors);
+        // in_ready / out_valid / out_sum are registers: already the pre-edge values
+        const uint8_t dut  = (uint8_t)((top->in_ready ? TX_IN_READY : 0) | (top->out_valid ? TX_OUT_VALID : 0));
+        const uint8_t want = r.flags & (TX_IN_READY | TX_OUT_VALID);
+        const uint64_t sum = AW::low64(AW::get(top->out_sum));
+        if (VL_UNLIKELY(dut != want || (r.transfer() && sum != r.sum))) {
+            if (diverged++ < 10)
+                std::fprintf(stderr, "[TB] replay diverges at cycle %llu: in_ready=%d out_valid=%d out_sum=%llx, "
+                                     "log in_ready=%d out_valid=%d out_sum=%llx\n",
+                             (unsigned long long)r.cycle, (int)top->in_ready, (int)top->out_valid,
+                             (unsigned long long)sum, !!(r.flags & TX_IN_READY),
+                             !!(r.flags & TX_OUT_VALID), (unsigned long long)r.sum);
+        }
+        const Op a = AW::from_u64(r.a), b = AW::from_u64(r.b);
+        cycle(bench, r.flags & TX_IN_VALID, a, b, AW::add(a, b), r.flags & TX_OUT_READY);
+        if (!nrec++) first = r.cycle;
+        last = r.cycle;
+        if (VL_UNLIKELY(bench.ctx->gotFinish())) break;
+    }
+    if (!log.error().empty()) std::fprintf(stderr, "[TB] +replay: %s: %s\n", path.c_str(), log.error().c_str());
+
+    // Drain what the window left in flight
+    end_of_test(bench, "RPL");
+    bench.perf.stop();
+
+    RunResult res = finish(bench, opts, t0, 0);
+    res.test = ~0u;
+    write_perf_json(opts.perf_path.c_str(), {res}, 1, res.secs);
+    std::printf("REPLAY: %llu records of %s (cycles %llu..%llu), %llu divergences from the log\n",
+                (unsigned long long)nrec, path.c_str(), (unsigned long long)first,
+                (unsigned long long)last, (unsigned long long)diverged);
+    if (res.errors || diverged || !log.error().empty()) {
+        std::fprintf(stderr, "TEST FAIL: %d mismatches, %llu divergences\n", res.errors,
+                     (unsigned long long)diverged);
+        return 1;
+    }
+    std::printf("TEST PASS\n");
+    return 0;
+}
+
+int main(int argc, char** argv) {
+
+    // captures the argc/argv from main() and stores
+    // them inside Verilator’s global runtime context
+    Verilated::commandArgs(argc, argv);
+
+    const TbArgs args(argc, argv);
+    if (args.has("help")) { usage(); return 0; }
+
+    const uint64_t seed   = args.u64("seed", 1);
+    const uint64_t nseeds = args.u64("seeds", 0);
+    const unsigned jobs   = (unsigned)args.u64("jobs", 0);
+    const bool     fork   = args.u64("fork", 0) != 0;
+    const std::string replay = args.str("replay", "");
+    const std::string txmode = args.str("txlog_mode", "cycle");
+    const std::string spec   = args.str("test", "random");
+    if (args.has("list")) { Tests::list(stdout); return 0; }
+
+    std::vector<std::string> unmatched;
+    const std::vector<std::size_t> tests = Tests::select(spec, &unmatched);
+
+    // Multi-job runs keep tracing opt-in so workers stay on the fast path
+    const RunOpts opts = run_opts_from_args(args, /*trace_default*/ nseeds == 0 && tests.size() == 1);
+
+    bool bad = false;
+    for (const std::string& e : args.errors())  { std::fprintf(stderr, "[TB] %s\n", e.c_str()); bad = true; }
+    for (const std::string& u : args.unknown()) { std::fprintf(stderr, "[TB] unknown option '%s' (see +help)\n", u.c_str()); bad = true; }
+    if (txmode != "cycle" && txmode != "txn") { std::fprintf(stderr, "[TB] +txlog_mode must be cycle or txn\n"); bad = true; }
+    for (const std::string& u : unmatched)     { std::fprintf(stderr, "[TB] +test: no test matches '%s' (see +list)\n", u.c_str()); bad = true; }
+    if (unmatched.empty() && tests.empty())    { std::fprintf(stderr, "[TB] +test: empty test list\n"); bad = true; }
+    if (!replay.empty() && nseeds > 0)         { std::fprintf(stderr, "[TB] +replay runs a single seed (drop +seeds)\n"); bad = true; }
+    if (!replay.empty() && args.has("test"))   { std::fprintf(stderr, "[TB] +replay replays a log; it runs no test (drop +test)\n"); bad = true; }
+    if (AW::kWide && (!replay.empty() || !opts.txlog_path.empty() || !opts.vectors_path.empty())) {
+        std::fprintf(stderr, "[TB] +txlog/+replay/+vectors use 64-bit fields; this model is %u bits wide\n", W);
+        bad = true;
+    }
+    if (!opts.vectors_path.empty() && !AW::kWide) {
+        VecStore st;
+        std::string err;
+        if (!st.open(opts.vectors_path, &err)) { std::fprintf(stderr, "[TB] +vectors: %s\n", err.c_str()); bad = true; }
+        else if (st.width() != W) {
+            std::fprintf(stderr, "[TB] +vectors: %s has %u-bit operands, this model %u\n",
+                         opts.vectors_path.c_str(), st.width(), W);
+            bad = true;
+        }
+    }
+    if (opts.checkpoint || opts.resume) {
+        // One model, one random phase; everything else would need checkpointing too
+        const bool single = nseeds == 0 && replay.empty() && tests.size() == 1 &&
+                            std::string(Tests::at(tests[0]).name) == "random";
+#if !TB_SAVABLE
+        std::fprintf(stderr, "[TB] +checkpoint/+resume need a model built with SAVABLE=1 (--savable)\n");
+        bad = true;
+#endif
+        if (!single)                  { std::fprintf(stderr, "[TB] +checkpoint/+resume need a single run of the random test\n"); bad = true; }
+        if (opts.cov_window)          { std::fprintf(stderr, "[TB] +checkpoint/+resume do not save +cov_window feedback state\n"); bad = true; }
+        if (!opts.txlog_path.empty()) { std::fprintf(stderr, "[TB] +txlog grows with the run and cannot resume; drop it for soak runs\n"); bad = true; }
+    }
+    if (!bad && opts.resume && ckpt_exists(opts.ckpt_path) && !soak_check(seed, opts)) bad = true;
+    if (bad) return 2;
+
+    if (!replay.empty()) return run_replay(replay, opts);
+
+    if (nseeds > 0 || tests.size() > 1) {
+        const std::vector<Job> matrix = job_matrix(tests, seed, nseeds);
+        if (fork) return run_fork(matrix, jobs, opts);
+        return run_regress(matrix, jobs, opts);
+    }
+
+    const RunResult r = run_seed((unsigned)tests[0], seed, opts);
+    write_perf_json(opts.perf_path.c_str(), {r}, 1, r.secs);
+    std::printf("PERF: %llu cycles, %.0f cycles/s -> %s\n", (unsigned long long)r.cycles,
+                r.perf.wall_s() > 0 ? r.cycles / r.perf.wall_s() : 0.0, opts.perf_path.c_str());
+    if (r.dut.cycles) {
+        std::printf("DUT: ");
+        r.dut.print(stdout);
+        std::printf("\n");
+    }
+    if (r.cov_points) {
+        std::printf("COVERAGE:");
+        cov_summary(r);
+        std::printf(" -> %s\n", opts.cov_path.c_str());
+    }
+    if (r.errors) {
+        std::fprintf(stderr, "TEST FAIL: %d mismatches\n", r.errors);
         return 1;
     }
     std::printf("TEST PASS\n");
@@ -0,0 +1,66 @@
+// sim/test_registry.h
+// Self-registering test cases for a single harness binary.
+//
+// A test is a function plus a name and a one-line description. A static
+// TestRegistry<Fn>::Add object next to its definition appends it to the
+// registry during static initialization, so adding a scenario means adding
+// one function; main() never lists tests by hand. Within one translation
+// unit, registration order is definition order.
+//
+// select("random,burst*") resolves a comma-separated list of names or
+// fnmatch(3) globs into registry indices, in registration order and each
+// at most once; a pattern that matches nothing is reported back.
+#pragma once
+
+#include <fnmatch.h>
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+template <class Fn>
+class TestRegistry {
+public:
+    struct Entry {
+        const char* name;
+        const char* doc;
+        Fn          fn;
+    };
+
+    struct Add {
+        Add(const char* name, const char* doc, Fn fn) { all().push_back(Entry{name, doc, fn}); }
+    };
+
+    static std::vector<Entry>& all() {
+        static std::vector<Entry> tests;
+        return tests;
+    }
+
+    static const Entry& at(std::size_t i) { return all()[i]; }
+
+    static std::vector<std::size_t> select(const std::string& spec, std::vector<std::string>* unmatched) {
+        const std::vector<Entry>& tests = all();
+        std::vector<bool> hit(tests.size(), false);
+        std::size_t pos = 0;
+        while (pos <= spec.size()) {
+            std::size_t end = spec.find(',', pos);
+            if (end == std::string::npos) end = spec.size();
+            const std::string pat = spec.substr(pos, end - pos);
+            pos = end + 1;
+            if (pat.empty()) continue;
+            bool any = false;
+            for (std::size_t i = 0; i < tests.size(); ++i)
+                if (fnmatch(pat.c_str(), tests[i].name, 0) == 0) hit[i] = any = true;
+            if (!any && unmatched) unmatched->push_back(pat);
+        }
+        std::vector<std::size_t> sel;
+        for (std::size_t i = 0; i < tests.size(); ++i)
+            if (hit[i]) sel.push_back(i);
+        return sel;
+    }
+
+    static void list(std::FILE* f) {
+        for (const Entry& e : all()) std::fprintf(f, "  %-16s %s\n", e.name, e.doc);
+    }
+};
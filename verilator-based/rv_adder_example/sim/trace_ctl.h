@@ -0,0 +1,154 @@
+// sim/trace_ctl.h
+// Runtime FST trace control: cycle window, start-on-mismatch trigger, depth/scope,
+// rotating size-capped segments.
+//
+// The tracer is created, attached and opened only when tracing actually starts,
+// so a run whose window never opens does no VerilatedFstC work at all. While
+// inactive, step() is a single predictable branch on the hot path. Models
+// built without --trace-fst (make TRACE=0) get an empty stand-in.
+//
+// With segment_bytes set, the trace goes to wave_seg<N>.fst files instead of
+// one growing file: every kCheckDumps dumps the segment is flushed and its size
+// checked, and past the cap a fresh tracer opens the next segment. Only the
+// newest `keep` segments stay on disk, so a soak run's trace is bounded.
+#pragma once
+
+#include "verilated.h"
+#if VM_TRACE_FST
+#include "verilated_fst_c.h"
+#endif
+
+#include <sys/stat.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+
+struct TraceOpts {
+    bool        enable   = true;          // master switch (+trace)
+    uint64_t    start    = 0;             // first traced cycle     (+trace_start)
+    uint64_t    stop     = UINT64_MAX;    // first untraced cycle   (+trace_stop)
+    bool        on_error = false;         // wait for first mismatch instead of start (+trace_on_error)
+    int         depth    = 5;             // hierarchy depth        (+trace_depth)
+    std::string scope;                    // dumpvars scope, e.g. "TOP.adder_rv_simple" (+trace_scope)
+    std::string path     = "logs/wave.fst";
+    uint64_t    segment_bytes = 0;        // rotate past this size, 0 = one file (+trace_segment_mb)
+    unsigned    keep     = 2;             // segments kept on disk (+trace_keep)
+};
+
+// "logs/wave.fst", 3 -> "logs/wave_seg003.fst"
+inline std::string trace_segment_path(const std::string& path, unsigned n) {
+    char tag[24];
+    std::snprintf(tag, sizeof tag, "_seg%03u", n);
+    const std::size_t slash = path.find_last_of('/');
+    const std::size_t dot   = path.find_last_of('.');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return path + tag;
+    return path.substr(0, dot) + tag + path.substr(dot);
+}
+
+#if VM_TRACE_FST
+
+template <class Model>
+class TraceCtl {
+public:
+    TraceCtl(Model* top, const TraceOpts& opts) : m_top(top), m_opts(opts) {
+        m_armed = opts.enable && opts.start < opts.stop;
+    }
+    ~TraceCtl() { close(); }
+
+    TraceCtl(const TraceCtl&) = delete;
+    TraceCtl& operator=(const TraceCtl&) = delete;
+
+    // Called once per half-cycle after eval(); time is the half-cycle count
+    inline void step(vluint64_t time) {
+        if (VL_LIKELY(!m_active)) {
+            if (VL_LIKELY(!m_armed) || m_opts.on_error || time / 2 < m_opts.start) return;
+            begin();
+        }
+        if (VL_UNLIKELY(time / 2 >= m_opts.stop)) { end(); return; }
+        m_tfp->dump(time);
+        if (VL_UNLIKELY(m_opts.segment_bytes && ++m_dumps % kCheckDumps == 0)) check_size();
+    }
+
+    // First scoreboard mismatch: start dumping now when +trace_on_error is set
+    inline void trigger(vluint64_t time) {
+        if (m_armed && m_opts.on_error && !m_active && time / 2 < m_opts.stop) begin();
+    }
+
+    void close() {
+        if (m_tfp) m_tfp->close();
+        m_tfp.reset();
+        m_active = false;
+    }
+
+    bool active() const { return m_active; }
+
+    // Segment numbering, carried across a checkpoint/resume
+    unsigned segment() const { return m_segment; }
+    void set_segment(unsigned n) { m_segment = n; }
+
+private:
+    static constexpr uint64_t kCheckDumps = 1u << 16;
+
+    void begin() {
+        open();
+        m_active = true;
+        m_armed  = false;          // one window per run
+    }
+
+    // A segmented trace opens a new tracer per segment (an FST file cannot be
+    // reopened); the model is attached to each in turn
+    void open() {
+        m_tfp = std::make_unique<VerilatedFstC>();
+        if (!m_opts.scope.empty()) m_tfp->dumpvars(m_opts.depth, m_opts.scope);
+        m_top->trace(m_tfp.get(), m_opts.depth);
+        if (!m_opts.segment_bytes) {
+            m_tfp->open(m_opts.path.c_str());
+            return;
+        }
+        m_tfp->open(trace_segment_path(m_opts.path, m_segment).c_str());
+        if (m_segment >= m_opts.keep)
+            std::remove(trace_segment_path(m_opts.path, m_segment - m_opts.keep).c_str());
+    }
+
+    void check_size() {
+        m_tfp->flush();
+        struct stat st;
+        if (::stat(trace_segment_path(m_opts.path, m_segment).c_str(), &st) != 0 ||
+            (uint64_t)st.st_size < m_opts.segment_bytes)
+            return;
+        m_tfp->close();
+        ++m_segment;
+        open();
+    }
+
+    void end() {
+        m_tfp->flush();
+        m_active = false;          // keep the file open, close() finalizes it
+    }
+
+    Model*                         m_top;
+    TraceOpts                      m_opts;
+    std::unique_ptr<VerilatedFstC> m_tfp;
+    bool                           m_armed  = false;
+    bool                           m_active = false;
+    uint64_t                       m_dumps  = 0;
+    unsigned                       m_segment = 0;
+};
+
+#else  // model built without --trace-fst: same interface, nothing to do
+
+template <class Model>
+class TraceCtl {
+public:
+    TraceCtl(Model*, const TraceOpts&) {}
+    inline void step(vluint64_t) {}
+    inline void trigger(vluint64_t) {}
+    void close() {}
+    bool active() const { return false; }
+    unsigned segment() const { return 0; }
+    void set_segment(unsigned) {}
+};
+
+#endif
@@ -0,0 +1,328 @@
+// sim/txlog.h
+// Compact binary transaction log (+txlog) and its reader (+replay,
+// sim/txlog_replay.cpp).
+//
+// The harness appends one record per evaluated cycle (cycle mode) or per
+// accepted transaction (txn mode) into a 1 MiB buffer. Full buffers go to a
+// background thread that writes them out, so the simulation thread never
+// waits on the disk. File layout, all little-endian:
+//
+//   0  char[4]  magic    "ADXL"
+//   4  u16      version  1
+//   6  u16      width    operand width in bits
+//   8  u8       mode     0 = cycle, 1 = txn
+//   9  u8[7]    reserved
+//  16  u64      seed
+//  24  u64      reserved
+//  32  records
+//
+// A record is a flags byte followed by the fields its flags call for:
+//   [GAP]                    varint: cycles before this one with no record
+//   [IN_VALID]               a, b     (width+7)/8 bytes each
+//   [OUT_VALID && OUT_READY] sum      (the word the DUT handed over)
+// The handshake bits are the pre-edge values. A record's cycle is the
+// previous record's cycle + 1 + gap (the first one counts from cycle 0), so
+// idle spans the harness fast-forwards over cost nothing. Txn logs only
+// record accepts (IN_VALID | IN_READY) plus MISMATCH markers: the data order
+// survives, the timing does not.
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum TxFlag : uint8_t {
+    TX_IN_VALID  = 1u << 0,
+    TX_IN_READY  = 1u << 1,
+    TX_OUT_VALID = 1u << 2,
+    TX_OUT_READY = 1u << 3,
+    TX_GAP       = 1u << 4,
+    TX_MISMATCH  = 1u << 5,   // the scoreboard failed on this cycle's transfer
+};
+
+enum class TxMode : uint8_t { CYCLE = 0, TXN = 1 };
+
+constexpr char     kTxMagic[4]     = {'A', 'D', 'X', 'L'};
+constexpr uint16_t kTxVersion      = 1;
+constexpr size_t   kTxHdrBytes     = 32;
+constexpr uint64_t kTxResetCycles  = 4;   // a replay resets for this long (as warmup() does)
+
+struct TxRec {
+    uint64_t cycle = 0;
+    uint8_t  flags = 0;       // without TX_GAP
+    uint64_t a = 0, b = 0, sum = 0;
+
+    bool accept()   const { return (flags & (TX_IN_VALID | TX_IN_READY)) == (TX_IN_VALID | TX_IN_READY); }
+    bool transfer() const { return (flags & (TX_OUT_VALID | TX_OUT_READY)) == (TX_OUT_VALID | TX_OUT_READY); }
+};
+
+namespace txlog_detail {
+
+inline void put_le(unsigned char* p, uint64_t v, unsigned n) {
+    for (unsigned i = 0; i < n; ++i) p[i] = (unsigned char)(v >> (8 * i));
+}
+
+inline uint64_t get_le(const unsigned char* p, unsigned n) {
+    uint64_t v = 0;
+    for (unsigned i = n; i-- > 0;) v = (v << 8) | p[i];
+    return v;
+}
+
+inline void put_header(unsigned char* h, unsigned width, TxMode mode, uint64_t seed) {
+    std::memset(h, 0, kTxHdrBytes);
+    std::memcpy(h, kTxMagic, 4);
+    put_le(h + 4, kTxVersion, 2);
+    put_le(h + 6, width, 2);
+    h[8] = (unsigned char)mode;
+    put_le(h + 16, seed, 8);
+}
+
+}  // namespace txlog_detail
+
+// Record encoder shared by the harness and the replay tool
+class TxEncoder {
+public:
+    static constexpr size_t kMaxRec = 1 + 10 + 3 * 8;
+
+    explicit TxEncoder(unsigned width = 32) : m_bytes((width + 7) / 8) {}
+
+    // Encode one record at p (room for kMaxRec); returns the bytes used
+    size_t put(unsigned char* p, const TxRec& r) {
+        unsigned char* q = p + 1;
+        uint8_t flags = r.flags & (uint8_t)~TX_GAP;
+        const uint64_t gap = r.cycle - m_next;
+        if (gap) {
+            flags |= TX_GAP;
+            for (uint64_t v = gap; ; v >>= 7) {
+                *q++ = (unsigned char)((v & 0x7f) | (v > 0x7f ? 0x80 : 0));
+                if (v <= 0x7f) break;
+            }
+        }
+        if (flags & TX_IN_VALID) {
+            txlog_detail::put_le(q, r.a, m_bytes); q += m_bytes;
+            txlog_detail::put_le(q, r.b, m_bytes); q += m_bytes;
+        }
+        if ((flags & (TX_OUT_VALID | TX_OUT_READY)) == (TX_OUT_VALID | TX_OUT_READY)) {
+            txlog_detail::put_le(q, r.sum, m_bytes); q += m_bytes;
+        }
+        *p = flags;
+        m_next = r.cycle + 1;
+        return (size_t)(q - p);
+    }
+
+    uint64_t next_cycle() const { return m_next; }
+
+private:
+    unsigned m_bytes;
+    uint64_t m_next = 0;    // cycle of a record with no gap
+};
+
+// Background-buffered writer used on the simulation hot path
+class TxLogWriter {
+public:
+    static constexpr size_t kBuf   = 1u << 20;
+    static constexpr size_t kSpare = 3;       // buffers in flight before append() has to wait
+
+    TxLogWriter() = default;
+    TxLogWriter(const TxLogWriter&) = delete;
+    TxLogWriter& operator=(const TxLogWriter&) = delete;
+    ~TxLogWriter() { close(); }
+
+    bool open(const std::string& path, TxMode mode, unsigned width, uint64_t seed) {
+        m_f = std::fopen(path.c_str(), "wb");
+        if (!m_f) return false;
+        m_mode = mode;
+        m_enc  = TxEncoder(width);
+        unsigned char h[kTxHdrBytes];
+        txlog_detail::put_header(h, width, mode, seed);
+        m_ok = std::fwrite(h, 1, sizeof h, m_f) == sizeof h;
+        m_bytes = sizeof h;
+        m_cur.resize(kBuf);
+        m_thread = std::thread([this] { drain(); });
+        return true;
+    }
+
+    // One evaluated cycle (pre-edge handshake flags, operands, pre-edge sum)
+    inline void cycle(uint64_t cyc, uint8_t flags, uint64_t a, uint64_t b, uint64_t sum) {
+        if (m_mode == TxMode::TXN) {
+            if ((flags & (TX_IN_VALID | TX_IN_READY)) != (TX_IN_VALID | TX_IN_READY)) return;
+            flags = TX_IN_VALID | TX_IN_READY;
+        }
+        append(TxRec{cyc, flags, a, b, sum});
+    }
+
+    // Scoreboard failure on cycle `cyc`: flag its record, or add one in txn mode
+    inline void mismatch(uint64_t cyc) {
+        if (m_last != kNoRec && m_enc.next_cycle() == cyc + 1) m_cur[m_last] |= TX_MISMATCH;
+        else append(TxRec{cyc, TX_MISMATCH, 0, 0, 0});
+    }
+
+    // Flush, stop the writer thread and close; false if anything failed
+    bool close() {
+        if (!m_f) return m_ok;
+        if (m_pos) hand_off();
+        {
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_stop = true;
+        }
+        m_cv.notify_all();
+        m_thread.join();
+        m_ok = (std::fclose(m_f) == 0) && m_ok;
+        m_f = nullptr;
+        return m_ok;
+    }
+
+    uint64_t records() const { return m_records; }
+    uint64_t bytes()   const { return m_bytes; }
+
+private:
+    static constexpr size_t kNoRec = ~(size_t)0;
+
+    inline void append(const TxRec& r) {
+        if (m_pos + TxEncoder::kMaxRec > kBuf) hand_off();
+        m_last = m_pos;
+        const size_t n = m_enc.put(&m_cur[m_pos], r);
+        m_pos += n;
+        m_bytes += n;
+        ++m_records;
+    }
+
+    void hand_off() {
+        std::vector<unsigned char> next;
+        {
+            std::unique_lock<std::mutex> lk(m_mx);
+            m_cv.wait(lk, [&] { return m_full.size() < kSpare; });
+            m_cur.resize(m_pos);
+            m_full.push_back(std::move(m_cur));
+            if (!m_free.empty()) { next = std::move(m_free.back()); m_free.pop_back(); }
+        }
+        m_cv.notify_all();
+        next.resize(kBuf);
+        m_cur  = std::move(next);
+        m_pos  = 0;
+        m_last = kNoRec;
+    }
+
+    void drain() {
+        for (;;) {
+            std::vector<unsigned char> buf;
+            {
+                std::unique_lock<std::mutex> lk(m_mx);
+                m_cv.wait(lk, [&] { return m_stop || !m_full.empty(); });
+                if (m_full.empty()) return;
+                buf = std::move(m_full.front());
+                m_full.pop_front();
+            }
+            m_cv.notify_all();
+            const bool ok = std::fwrite(buf.data(), 1, buf.size(), m_f) == buf.size();
+            std::lock_guard<std::mutex> lk(m_mx);
+            m_ok = m_ok && ok;
+            m_free.push_back(std::move(buf));
+        }
+    }
+
+    std::FILE*  m_f    = nullptr;
+    TxMode      m_mode = TxMode::CYCLE;
+    TxEncoder   m_enc;
+    std::vector<unsigned char> m_cur;           // buffer being filled
+    size_t      m_pos  = 0;
+    size_t      m_last = kNoRec;                // offset of the last record's flags in m_cur
+    uint64_t    m_records = 0, m_bytes = 0;
+    bool        m_ok   = true;
+
+    std::thread m_thread;
+    std::mutex  m_mx;
+    std::condition_variable m_cv;
+    std::deque<std::vector<unsigned char>>  m_full;   // waiting for the writer
+    std::vector<std::vector<unsigned char>> m_free;   // written, reusable
+    bool        m_stop = false;
+};
+
+// Sequential reader
+class TxLogReader {
+public:
+    TxLogReader() = default;
+    TxLogReader(const TxLogReader&) = delete;
+    TxLogReader& operator=(const TxLogReader&) = delete;
+    ~TxLogReader() { if (m_f) std::fclose(m_f); }
+
+    // false with the reason in error()
+    bool open(const std::string& path) {
+        m_f = std::fopen(path.c_str(), "rb");
+        if (!m_f) { m_err = "cannot open " + path; return false; }
+        unsigned char h[kTxHdrBytes];
+        if (std::fread(h, 1, sizeof h, m_f) != sizeof h || std::memcmp(h, kTxMagic, 4) != 0
+            || txlog_detail::get_le(h + 4, 2) != kTxVersion) {
+            m_err = path + " is not a v" + std::to_string(kTxVersion) + " transaction log";
+            return false;
+        }
+        m_width = (unsigned)txlog_detail::get_le(h + 6, 2);
+        m_mode  = (TxMode)h[8];
+        m_seed  = txlog_detail::get_le(h + 16, 8);
+        if (m_width == 0 || m_width > 64) { m_err = path + ": unsupported width"; return false; }
+        m_bytes = (m_width + 7) / 8;
+        m_buf.resize(1u << 20);
+        return true;
+    }
+
+    // Next record; false at the end (or on a truncated record, see error())
+    bool next(TxRec& r) {
+        if (!fill(1)) return false;
+        uint8_t flags = m_buf[m_pos];
+        uint64_t gap = 0;
+        size_t need = 1;
+        if (flags & TX_GAP) {
+            for (unsigned s = 0; ; s += 7) {
+                if (!fill(need + 1)) return truncated();
+                const unsigned char c = m_buf[m_pos + need++];
+                gap |= (uint64_t)(c & 0x7f) << s;
+                if (!(c & 0x80)) break;
+            }
+        }
+        const bool in  = flags & TX_IN_VALID;
+        const bool out = (flags & (TX_OUT_VALID | TX_OUT_READY)) == (TX_OUT_VALID | TX_OUT_READY);
+        const size_t body = (in ? 2 : 0) * m_bytes + (out ? m_bytes : 0);
+        if (!fill(need + body)) return truncated();
+        const unsigned char* p = &m_buf[m_pos + need];
+        r.cycle = m_next + gap;
+        r.flags = flags & (uint8_t)~TX_GAP;
+        r.a = r.b = r.sum = 0;
+        if (in)  { r.a = txlog_detail::get_le(p, m_bytes); r.b = txlog_detail::get_le(p + m_bytes, m_bytes); p += 2 * m_bytes; }
+        if (out) { r.sum = txlog_detail::get_le(p, m_bytes); }
+        m_pos += need + body;
+        m_next = r.cycle + 1;
+        return true;
+    }
+
+    unsigned           width() const { return m_width; }
+    TxMode             mode()  const { return m_mode; }
+    uint64_t           seed()  const { return m_seed; }
+    const std::string& error() const { return m_err; }
+
+private:
+    // Make n bytes available at m_pos
+    bool fill(size_t n) {
+        if (m_end - m_pos >= n) return true;
+        std::memmove(m_buf.data(), m_buf.data() + m_pos, m_end - m_pos);
+        m_end -= m_pos;
+        m_pos = 0;
+        m_end += std::fread(m_buf.data() + m_end, 1, m_buf.size() - m_end, m_f);
+        return m_end >= n;
+    }
+
+    bool truncated() { m_err = "truncated record"; return false; }
+
+    std::FILE* m_f = nullptr;
+    std::vector<unsigned char> m_buf;
+    size_t   m_pos = 0, m_end = 0;
+    unsigned m_width = 0, m_bytes = 0;
+    TxMode   m_mode = TxMode::CYCLE;
+    uint64_t m_seed = 0, m_next = 0;
+    std::string m_err;
+};
@@ -0,0 +1,240 @@
+// sim/txlog_replay.cpp
+// Cut a cycle window out of a +txlog transaction log (txlog.h) for a rerun
+// on a slower simulator:
+//
+//   txlog_replay [--from=C] [--to=C] [--fail[=N]] [--log=OUT.txl]
+//                [--vectors=OUT.bin] [--text=OUT.txt]  LOG
+//
+//   --from / --to   window, inclusive cycle numbers (default: the whole log)
+//   --fail[=N]      window = N cycles (default 1000) up to the first mismatch,
+//                   plus 8 cycles after it
+//   --log           the window as a cycle log for `sim_adder_rv_simple +replay=`
+//                   (fully traced Verilator rerun, original cycle numbers)
+//   --vectors       the window's accepted operands as an ADDB input file for the
+//                   file-based Questa flow (cosim_tb --vectors=); --text writes
+//                   the same operands in its hex text format
+//
+// Only the two elastic slots carry state from one cycle to the next, so a
+// window starts from the transactions still in flight at its first cycle:
+// they lead the vector list, and the window log re-accepts them with
+// out_ready low in the cycles just before the window, which refills both
+// slots in order. Txn logs have no transfer records, so their windows are
+// vectors only and have no in-flight prefix.
+//
+// Without an output option the log is only summarised.
+//
+// Build (the Makefile target txlog-replay does this):
+//   g++ -O2 -std=c++17 -o txlog_replay txlog_replay.cpp
+#include "txlog.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <string>
+#include <utility>
+
+static int usage(const char* prog) {
+    std::fprintf(stderr, "usage: %s [--from=C] [--to=C] [--fail[=N]] [--log=OUT] [--vectors=OUT.bin]"
+                         " [--text=OUT.txt] LOG\n", prog);
+    return 2;
+}
+
+// ADDB (cosim_tb.cpp "Binary vector files"): count is patched in at close
+class VecOut {
+public:
+    bool open(const std::string& path, unsigned width, bool text) {
+        m_f = std::fopen(path.c_str(), text ? "w" : "wb");
+        if (!m_f) return false;
+        m_text  = text;
+        m_width = width;
+        m_bytes = (width + 7) / 8;
+        if (!text) {
+            unsigned char h[16] = {'A', 'D', 'D', 'B'};
+            txlog_detail::put_le(h + 4, 1, 2);
+            txlog_detail::put_le(h + 6, width, 2);
+            std::fwrite(h, 1, sizeof h, m_f);
+        }
+        return true;
+    }
+    void put(uint64_t a, uint64_t b) {
+        if (m_text) {
+            const int digits = (int)(m_width + 3) / 4;
+            std::fprintf(m_f, "%0*llx %0*llx\n", digits, (unsigned long long)a, digits, (unsigned long long)b);
+        } else {
+            unsigned char r[16];
+            txlog_detail::put_le(r, a, m_bytes);
+            txlog_detail::put_le(r + m_bytes, b, m_bytes);
+            std::fwrite(r, 1, 2 * m_bytes, m_f);
+        }
+        ++m_count;
+    }
+    bool close() {
+        if (!m_f) return true;
+        if (!m_text) {
+            unsigned char c[8];
+            txlog_detail::put_le(c, m_count, 8);
+            std::fseek(m_f, 8, SEEK_SET);
+            std::fwrite(c, 1, sizeof c, m_f);
+        }
+        const bool ok = !std::ferror(m_f);
+        return (std::fclose(m_f) == 0) && ok;
+    }
+    uint64_t count() const { return m_count; }
+    explicit operator bool() const { return m_f != nullptr; }
+
+private:
+    std::FILE* m_f = nullptr;
+    bool       m_text = false;
+    unsigned   m_width = 0, m_bytes = 0;
+    uint64_t   m_count = 0;
+};
+
+int main(int argc, char** argv) {
+    uint64_t from = 0, to = ~0ull, fail_n = 0;
+    bool fail = false, from_set = false;
+    std::string log_out, vec_out, txt_out, in;
+    for (int i = 1; i < argc; ++i) {
+        const char* a = argv[i];
+        auto val = [&](const char* key) -> const char* {
+            const std::size_t n = std::strlen(key);
+            return std::strncmp(a, key, n) == 0 ? a + n : nullptr;
+        };
+        if (const char* v = val("--from="))         { from = std::strtoull(v, nullptr, 0); from_set = true; }
+        else if (const char* v = val("--to="))      to = std::strtoull(v, nullptr, 0);
+        else if (const char* v = val("--fail="))    { fail = true; fail_n = std::strtoull(v, nullptr, 0); }
+        else if (!std::strcmp(a, "--fail"))         { fail = true; fail_n = 1000; }
+        else if (const char* v = val("--log="))     log_out = v;
+        else if (const char* v = val("--vectors=")) vec_out = v;
+        else if (const char* v = val("--text="))    txt_out = v;
+        else if (a[0] == '-' || !in.empty())        return usage(argv[0]);
+        else                                        in = a;
+    }
+    if (in.empty() || (fail && from_set)) return usage(argv[0]);
+
+    TxLogReader log;
+    if (!log.open(in)) { std::fprintf(stderr, "txlog_replay: %s\n", log.error().c_str()); return 1; }
+    const bool cycle_log = log.mode() == TxMode::CYCLE;
+    TxRec r;
+
+    // --fail: locate the first mismatch first
+    if (fail) {
+        TxLogReader scan;
+        scan.open(in);
+        bool found = false;
+        while (scan.next(r))
+            if (r.flags & TX_MISMATCH) { found = true; break; }
+        if (!found) { std::fprintf(stderr, "txlog_replay: no mismatch in %s\n", in.c_str()); return 1; }
+        from = r.cycle > fail_n ? r.cycle - fail_n : 0;
+        to   = r.cycle + 8;
+    }
+    if (!log_out.empty() && !cycle_log) {
+        std::fprintf(stderr, "txlog_replay: %s is a txn log; --log needs a cycle log (+txlog_mode=cycle)\n",
+                     in.c_str());
+        return 1;
+    }
+
+    std::FILE* lf = nullptr;
+    TxEncoder  enc(log.width());
+    if (!log_out.empty()) {
+        lf = std::fopen(log_out.c_str(), "wb");
+        if (!lf) { std::fprintf(stderr, "txlog_replay: cannot write %s\n", log_out.c_str()); return 1; }
+        unsigned char h[kTxHdrBytes];
+        txlog_detail::put_header(h, log.width(), TxMode::CYCLE, log.seed());
+        std::fwrite(h, 1, sizeof h, lf);
+    }
+    VecOut vec, txt;
+    if (!vec_out.empty() && !vec.open(vec_out, log.width(), false)) {
+        std::fprintf(stderr, "txlog_replay: cannot write %s\n", vec_out.c_str());
+        return 1;
+    }
+    if (!txt_out.empty() && !txt.open(txt_out, log.width(), true)) {
+        std::fprintf(stderr, "txlog_replay: cannot write %s\n", txt_out.c_str());
+        return 1;
+    }
+    auto put_log = [&](const TxRec& rec) {
+        if (!lf) return;
+        unsigned char buf[TxEncoder::kMaxRec];
+        std::fwrite(buf, 1, enc.put(buf, rec), lf);
+    };
+    auto put_vec = [&](uint64_t a, uint64_t b) {
+        if (vec) vec.put(a, b);
+        if (txt) txt.put(a, b);
+    };
+
+    // Operands accepted but not yet handed over, oldest first
+    std::deque<std::pair<uint64_t, uint64_t>> inflight;
+    uint64_t nrec = 0, first = 0, last = 0, acc = 0, xfer = 0, mism = 0, first_mism = 0;
+    uint64_t win_rec = 0, win_acc = 0, prefix = 0;
+    bool in_window = false;
+
+    auto open_window = [&] {
+        in_window = true;
+        prefix = inflight.size();
+        if (prefix && (prefix > from || from - prefix < kTxResetCycles)) {
+            std::fprintf(stderr, "txlog_replay: %llu transactions in flight at cycle %llu, too close to reset\n",
+                         (unsigned long long)prefix, (unsigned long long)from);
+            return false;
+        }
+        uint64_t c = from - prefix;
+        for (std::size_t i = 0; i < inflight.size(); ++i, ++c) {
+            const auto& op = inflight[i];
+            put_log(TxRec{c, (uint8_t)(TX_IN_VALID | TX_IN_READY | (i ? TX_OUT_VALID : 0)), op.first, op.second, 0});
+            put_vec(op.first, op.second);
+        }
+        return true;
+    };
+
+    bool ok = true;
+    while (ok && log.next(r)) {
+        if (!nrec++) first = r.cycle;
+        last = r.cycle;
+        if (r.accept())   ++acc;
+        if (r.transfer()) ++xfer;
+        if ((r.flags & TX_MISMATCH) && !mism++) first_mism = r.cycle;
+        if (r.cycle > to) continue;
+
+        if (r.cycle >= from) {
+            if (!in_window && !(ok = open_window())) break;
+            put_log(r);
+            if (r.accept()) { put_vec(r.a, r.b); ++win_acc; }
+            ++win_rec;
+            continue;
+        }
+        // Before the window: track what is in flight (POP, then ENQ)
+        if (cycle_log && r.transfer() && !inflight.empty()) inflight.pop_front();
+        if (cycle_log && r.accept()) inflight.emplace_back(r.a, r.b);
+    }
+    if (!log.error().empty()) { std::fprintf(stderr, "txlog_replay: %s: %s\n", in.c_str(), log.error().c_str()); ok = false; }
+    if (ok && !in_window && (lf || vec || txt)) std::fprintf(stderr, "txlog_replay: window is empty\n");
+
+    std::printf("%s: %s log, %u-bit, seed %llu, %llu records, cycles %llu..%llu\n", in.c_str(),
+                cycle_log ? "cycle" : "txn", log.width(), (unsigned long long)log.seed(),
+                (unsigned long long)nrec, (unsigned long long)first, (unsigned long long)last);
+    std::printf("  %llu accepted, %llu handed over, %llu mismatches", (unsigned long long)acc,
+                (unsigned long long)xfer, (unsigned long long)mism);
+    if (mism) std::printf(" (first at cycle %llu)", (unsigned long long)first_mism);
+    std::printf("\n");
+    if (lf || vec || txt) {
+        std::printf("  window %llu..", (unsigned long long)from);
+        if (to == ~0ull) std::printf("end"); else std::printf("%llu", (unsigned long long)to);
+        std::printf(": %llu records, %llu accepted, %llu in flight at its start\n",
+                    (unsigned long long)win_rec, (unsigned long long)win_acc, (unsigned long long)prefix);
+    }
+
+    if (lf)  ok = (std::fclose(lf) == 0) && ok;
+    if (vec) ok = vec.close() && ok;
+    if (txt) ok = txt.close() && ok;
+    if (!ok) {
+        // A partial window would replay something else: leave no outputs behind
+        for (const std::string* p : {&log_out, &vec_out, &txt_out})
+            if (!p->empty()) std::remove(p->c_str());
+        return 1;
+    }
+    if (lf)  std::printf("  -> %s (replay: +replay=%s)\n", log_out.c_str(), log_out.c_str());
+    if (vec) std::printf("  -> %s (%llu vectors)\n", vec_out.c_str(), (unsigned long long)vec.count());
+    if (txt) std::printf("  -> %s (%llu vectors)\n", txt_out.c_str(), (unsigned long long)txt.count());
+    return 0;
+}